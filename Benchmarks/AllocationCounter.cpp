@@ -0,0 +1,42 @@
+#include "AllocationCounter.h"
+
+#ifdef GAME_ENGINE_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new and delete of the whole program, so only the benchmarks build this file
+static std::atomic<uint64_t> allocationCount{ 0 };
+
+static void* countedAllocate(size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+	return std::malloc(size ? size : 1);
+}
+
+void* operator new(size_t size) {
+	void* memory = countedAllocate(size);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](size_t size) {
+	void* memory = countedAllocate(size);
+	if (!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+
+bool AllocationCounter::isEnabled() { return true; }
+uint64_t AllocationCounter::getCount() { return allocationCount.load(std::memory_order_relaxed); }
+#else
+bool AllocationCounter::isEnabled() { return false; }
+uint64_t AllocationCounter::getCount() { return 0; }
+#endif
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts the heap allocations of the whole process made through operator new, to check that steady state
+// steps do not allocate. Configure with -DGAME_ENGINE_COUNT_ALLOCATIONS=ON to enable it; otherwise the count
+// stays 0.
+class AllocationCounter {
+public:
+	static bool isEnabled();
+	// Allocations since the process started. Safe to call from any thread.
+	static uint64_t getCount();
+};
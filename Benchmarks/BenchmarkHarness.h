@@ -0,0 +1,219 @@
+#pragma once
+
+#include "AllocationCounter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __APPLE__
+#include <nlohmann/json.hpp>
+#else
+#include <JSON/json.hpp>
+#endif
+
+// Passed to every benchmark case. The case sets up its data, then loops while keepRunning()
+// returns true; each loop iteration is timed as one sample.
+class BenchmarkState {
+public:
+	BenchmarkState(int entities, double minSeconds, uint64_t maxIterations)
+		: _entities(entities), _minNs(static_cast<int64_t>(minSeconds * 1e9)), _maxIterations(maxIterations) {}
+
+	int entities() const { return _entities; }
+
+	bool keepRunning() {
+		int64_t now = clock();
+		uint64_t allocations = AllocationCounter::getCount();
+		if (_started) {
+			_samples.push_back(_accumulatedNs + now - _iterationStart);
+			_totalNs += _samples.back();
+			_allocations += _accumulatedAllocations + allocations - _allocationStart;
+		}
+		_started = true;
+
+		if (_samples.size() >= _maxIterations || (_totalNs >= _minNs && !_samples.empty())) return false;
+
+		_accumulatedNs = 0;
+		_accumulatedAllocations = 0;
+		_allocationStart = AllocationCounter::getCount();
+		_iterationStart = clock();
+		return true;
+	}
+
+	// Excludes per-iteration setup from the measurement
+	void pauseTiming() {
+		_accumulatedNs += clock() - _iterationStart;
+		_accumulatedAllocations += AllocationCounter::getCount() - _allocationStart;
+	}
+	void resumeTiming() {
+		_allocationStart = AllocationCounter::getCount();
+		_iterationStart = clock();
+	}
+
+	// Number of operations done by one iteration, for cases that batch very short operations
+	void setItemsPerIteration(int items) { _itemsPerIteration = items; }
+	int getItemsPerIteration() const { return _itemsPerIteration; }
+
+	std::vector<int64_t>& getSamples() { return _samples; }
+	// Heap allocations of all timed iterations, if AllocationCounter is enabled
+	uint64_t getAllocations() const { return _allocations; }
+
+private:
+	static int64_t clock() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	int _entities;
+	int64_t _minNs;
+	uint64_t _maxIterations;
+	int _itemsPerIteration = 1;
+
+	bool _started = false;
+	int64_t _iterationStart = 0;
+	int64_t _accumulatedNs = 0;
+	int64_t _totalNs = 0;
+	std::vector<int64_t> _samples;
+	uint64_t _allocationStart = 0;
+	uint64_t _accumulatedAllocations = 0;
+	uint64_t _allocations = 0;
+};
+
+// Runs registered benchmark cases for every configured entity count and reports the results as JSON.
+// Options: --entities=100,1000 --min-time=<seconds> --max-iterations=<n> --filter=<substring> --out=<file>
+// Built with GAME_ENGINE_COUNT_ALLOCATIONS, results also carry the heap allocations per operation.
+class BenchmarkHarness {
+public:
+	using Case = std::function<void(BenchmarkState&)>;
+
+	BenchmarkHarness(int argc, char** argv) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			std::string value = arg.find('=') != std::string::npos ? arg.substr(arg.find('=') + 1) : "";
+
+			if (arg.rfind("--entities=", 0) == 0) {
+				_entityCounts.clear();
+				size_t start = 0;
+				while (start < value.size()) {
+					size_t end = value.find(',', start);
+					if (end == std::string::npos) end = value.size();
+					_entityCounts.push_back(std::atoi(value.substr(start, end - start).c_str()));
+					start = end + 1;
+				}
+			}
+			else if (arg.rfind("--min-time=", 0) == 0) _minSeconds = std::atof(value.c_str());
+			else if (arg.rfind("--max-iterations=", 0) == 0) _maxIterations = std::strtoull(value.c_str(), nullptr, 10);
+			else if (arg.rfind("--filter=", 0) == 0) _filter = value;
+			else if (arg.rfind("--out=", 0) == 0) _outPath = value;
+			else {
+				fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+				fprintf(stderr, "Options: --entities=100,1000 --min-time=<seconds> --max-iterations=<n> --filter=<substring> --out=<file>\n");
+				std::exit(1);
+			}
+		}
+	}
+
+	// Registers a case that runs once per entity count
+	void add(const std::string& name, const Case& benchmark) { _cases.push_back({ name, benchmark, true }); }
+	// Registers a case whose cost does not depend on the entity count. It runs once, reported with 0 entities.
+	void addFixed(const std::string& name, const Case& benchmark) { _cases.push_back({ name, benchmark, false }); }
+
+	// Runs all cases that match the filter. Returns the process exit code.
+	int run() {
+		nlohmann::json results = nlohmann::json::array();
+
+		for (const Registered& registered : _cases) {
+			if (!_filter.empty() && registered.name.find(_filter) == std::string::npos) continue;
+
+			std::vector<int> counts = registered.scalesWithEntities ? _entityCounts : std::vector<int>{ 0 };
+			for (int entities : counts) {
+				BenchmarkState state(entities, _minSeconds, _maxIterations);
+				registered.benchmark(state);
+				results.push_back(summarize(registered.name, state));
+
+				const nlohmann::json& result = results.back();
+				fprintf(stderr, "%-40s %8d %12.0f ns/op %10llu iterations", registered.name.c_str(), entities,
+					result["mean_ns"].get<double>(), static_cast<unsigned long long>(result["iterations"].get<uint64_t>()));
+				if (result.contains("allocations_per_op")) fprintf(stderr, " %10.1f allocs/op", result["allocations_per_op"].get<double>());
+				fprintf(stderr, "\n");
+			}
+		}
+
+		nlohmann::json report = {
+			{ "context", {
+				{ "timestamp", static_cast<int64_t>(std::time(nullptr)) },
+				{ "hardware_threads", std::thread::hardware_concurrency() },
+				{ "counts_allocations", AllocationCounter::isEnabled() },
+				{ "min_time_s", _minSeconds }
+			} },
+			{ "benchmarks", results }
+		};
+
+		if (_outPath.empty()) {
+			printf("%s\n", report.dump(2).c_str());
+			return 0;
+		}
+
+		std::ofstream out(_outPath);
+		if (!out) {
+			fprintf(stderr, "Could not write %s\n", _outPath.c_str());
+			return 1;
+		}
+		out << report.dump(2) << "\n";
+		return 0;
+	}
+
+private:
+	struct Registered {
+		std::string name;
+		Case benchmark;
+		bool scalesWithEntities;
+	};
+
+	// Reports per-operation times: samples are divided by the items done in one iteration
+	static nlohmann::json summarize(const std::string& name, BenchmarkState& state) {
+		std::vector<int64_t>& samples = state.getSamples();
+		double items = state.getItemsPerIteration();
+		std::sort(samples.begin(), samples.end());
+
+		double total = 0;
+		for (int64_t sample : samples) total += static_cast<double>(sample);
+
+		double mean = samples.empty() ? 0 : total / samples.size() / items;
+		auto percentile = [&samples, items](double p) {
+			if (samples.empty()) return 0.0;
+			size_t index = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+			return samples[index] / items;
+		};
+
+		nlohmann::json result = {
+			{ "name", name },
+			{ "entities", state.entities() },
+			{ "iterations", static_cast<uint64_t>(samples.size()) },
+			{ "items_per_iteration", state.getItemsPerIteration() },
+			{ "mean_ns", mean },
+			{ "min_ns", percentile(0.0) },
+			{ "p50_ns", percentile(0.5) },
+			{ "p99_ns", percentile(0.99) },
+			{ "max_ns", percentile(1.0) },
+			{ "ops_per_second", mean > 0 ? 1e9 / mean : 0.0 }
+		};
+		if (AllocationCounter::isEnabled() && !samples.empty()) {
+			result["allocations_per_op"] = static_cast<double>(state.getAllocations()) / samples.size() / items;
+		}
+		return result;
+	}
+
+	std::vector<Registered> _cases;
+	std::vector<int> _entityCounts = { 100, 1000, 10000 };
+	double _minSeconds = 0.5;
+	uint64_t _maxIterations = 1000000;
+	std::string _filter;
+	std::string _outPath;
+};
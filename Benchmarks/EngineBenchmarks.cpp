@@ -0,0 +1,373 @@
+#include "BenchmarkHarness.h"
+#include "Client.h"
+#include "CollisionSystem.h"
+#include "Entity.h"
+#include "EventManager.h"
+#include "GameEngine.h"
+#include "InputManager.h"
+#include "PhysicsSystem.h"
+#include "Server.h"
+#include "StaticIndex.h"
+#include "ThreadPool.h"
+#include "Timeline.h"
+#include "WorldBlob.h"
+#include "CollisionEvent.cpp"
+#include "EntityUpdateEvent.cpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
+
+// Scatters moving bodies over a square world sized so that the density stays the same for every count
+static std::vector<std::unique_ptr<Entity>> makeBodies(int count) {
+	std::vector<std::unique_ptr<Entity>> bodies;
+	int worldSize = std::max(200, static_cast<int>(std::sqrt(static_cast<double>(count)) * 100));
+
+	srand(42);
+	for (int i = 0; i < count; i++) {
+		Entity* body = new Entity(Position(static_cast<float>(rand() % worldSize), static_cast<float>(rand() % worldSize)), Size(20, 20));
+		body->setEntityID(i);
+		body->setVelocityX(static_cast<float>(rand() % 21 - 10));
+		body->setVelocityY(static_cast<float>(rand() % 21 - 10));
+		body->setAccelerationY(9.8f);
+		bodies.emplace_back(body);
+	}
+	return bodies;
+}
+
+static std::vector<Entity*> pointers(const std::vector<std::unique_ptr<Entity>>& owners) {
+	std::vector<Entity*> entities;
+	for (const auto& owner : owners) entities.push_back(owner.get());
+	return entities;
+}
+
+// Headless benchmarks of the engine subsystems. Prints JSON results to stdout (or --out) and progress to stderr.
+int main(int argc, char** argv) {
+	BenchmarkHarness harness(argc, argv);
+
+	harness.add("PhysicsSystem::run", [](BenchmarkState& state) {
+		auto bodies = makeBodies(state.entities());
+		PhysicsSystem physicsSystem;
+		physicsSystem.setEntities(pointers(bodies));
+		while (state.keepRunning()) {
+			physicsSystem.run(0.016f);
+		}
+	});
+
+	harness.add("CollisionSystem::run", [](BenchmarkState& state) {
+		auto bodies = makeBodies(state.entities());
+		std::vector<Entity*> entities = pointers(bodies);
+		Timeline timeline;
+		EventManager eventManager(&timeline);
+
+		while (state.keepRunning()) {
+			CollisionSystem::getInstance().run(entities, &eventManager);
+
+			state.pauseTiming();
+			eventManager.process();
+			state.resumeTiming();
+		}
+	});
+
+	// Same bodies, but a third of them are circles and a third triangles of the same extent
+	harness.add("CollisionSystem::run (mixed shapes)", [](BenchmarkState& state) {
+		auto bodies = makeBodies(state.entities());
+		for (size_t i = 0; i < bodies.size(); i++) {
+			if (i % 3 == 0) continue;
+			Position position = bodies[i]->getOriginalPosition();
+			Entity* shape = i % 3 == 1 ? new Entity(Position(position.x + 10, position.y + 10), 10.0f) : new Entity(Position(position.x, position.y + 20), 20.0f, 20.0f);
+			shape->setEntityID(bodies[i]->getEntityID());
+			shape->setVelocityX(bodies[i]->getVelocityX());
+			shape->setVelocityY(bodies[i]->getVelocityY());
+			shape->setAccelerationY(bodies[i]->getAccelerationY());
+			bodies[i].reset(shape);
+		}
+		std::vector<Entity*> entities = pointers(bodies);
+		Timeline timeline;
+		EventManager eventManager(&timeline);
+
+		while (state.keepRunning()) {
+			CollisionSystem::getInstance().run(entities, &eventManager);
+
+			state.pauseTiming();
+			eventManager.process();
+			state.resumeTiming();
+		}
+	});
+
+	// Bodies leaving and joining a populated world, as players do: every iteration removes 100 bodies from
+	// all over the world and adds them back
+	harness.add("GameEngine::removeEntity + addEntity", [](BenchmarkState& state) {
+		auto bodies = makeBodies(state.entities());
+		GameEngine engine("Benchmark", 0, 0, Mode::SERVER);
+		std::vector<Entity*> noEntities;
+		engine.initialize(noEntities);
+		PhysicsSystem* physicsSystem = engine.getPhysicsSystem();
+		for (auto& body : bodies) {
+			engine.addEntity(body.get());
+			physicsSystem->addEntity(*body);
+		}
+
+		const int churn = std::min(100, state.entities());
+		size_t next = 0;
+		state.setItemsPerIteration(churn);
+		while (state.keepRunning()) {
+			for (int i = 0; i < churn; i++) {
+				Entity* body = bodies[(next + i * 7919) % bodies.size()].get();
+				engine.removeEntity(body);
+				engine.addEntity(body);
+				physicsSystem->addEntity(*body);
+			}
+			next++;
+		}
+		physicsSystem->initialize();
+	});
+
+	// As many fixed platforms as moving bodies. Only the bodies are paired; platforms come from the static grid.
+	auto staticWorldRun = [](BenchmarkState& state, ThreadPool* threadPool) {
+		auto bodies = makeBodies(state.entities());
+		auto platforms = makeBodies(state.entities());
+		for (auto& platform : platforms) {
+			platform->setEntityType(EntityType::FIXED);
+			platform->setSize(Size(60, 10));
+			platform->setStatic(true);
+			bodies.push_back(std::move(platform));
+		}
+		std::vector<Entity*> entities = pointers(bodies);
+		StaticIndex staticIndex;
+		Timeline timeline;
+		EventManager eventManager(&timeline);
+
+		while (state.keepRunning()) {
+			CollisionSystem::getInstance().run(entities, staticIndex, &eventManager, threadPool);
+
+			state.pauseTiming();
+			eventManager.process();
+			state.resumeTiming();
+		}
+	};
+	harness.add("CollisionSystem::run (static world)", [staticWorldRun](BenchmarkState& state) { staticWorldRun(state, nullptr); });
+	harness.add("CollisionSystem::run (static world, all cores)", [staticWorldRun](BenchmarkState& state) {
+		ThreadPool threadPool;
+		staticWorldRun(state, &threadPool);
+	});
+
+	// One server tick (collisions, events and physics) of a world where nine in ten bodies rest on a platform
+	auto restingWorldTick = [](BenchmarkState& state, bool sleep) {
+		auto bodies = makeBodies(state.entities());
+		std::vector<std::unique_ptr<Entity>> platforms;
+		for (size_t i = 0; i < bodies.size(); i++) {
+			if (i % 10 == 0) continue;
+			bodies[i]->setVelocityX(0);
+			bodies[i]->setVelocityY(0);
+
+			Position position = bodies[i]->getOriginalPosition();
+			Entity* platform = new Entity(Position(position.x - 10, position.y + 19), Size(40, 10));
+			platform->setEntityType(EntityType::FIXED);
+			platform->setStatic(true);
+			platforms.emplace_back(platform);
+		}
+
+		std::vector<Entity*> entities = pointers(bodies);
+		for (const auto& platform : platforms) entities.push_back(platform.get());
+		PhysicsSystem physicsSystem;
+		physicsSystem.setEntities(pointers(bodies));
+		physicsSystem.setSleepThreshold(sleep ? 0.1f : -1.0f, 60);
+		StaticIndex staticIndex;
+		Timeline timeline;
+		EventManager eventManager(&timeline);
+		eventManager.registerHandler(EventType::Collision, [](const Event* event) {
+			const CollisionEvent* collision = static_cast<const CollisionEvent*>(event);
+			CollisionSystem::getInstance().handleCollision(collision->getEntityA());
+			CollisionSystem::getInstance().handleCollision(collision->getEntityB());
+		});
+
+		auto tick = [&]() {
+			CollisionSystem::getInstance().run(entities, staticIndex, &eventManager);
+			eventManager.process();
+			physicsSystem.run(0.016f);
+		};
+		for (int i = 0; i < 100; i++) tick();                  // Lets the resting bodies fall asleep
+
+		while (state.keepRunning()) tick();
+	};
+	harness.add("Simulation tick (resting world)", [restingWorldTick](BenchmarkState& state) { restingWorldTick(state, true); });
+	harness.add("Simulation tick (resting world, no sleep)", [restingWorldTick](BenchmarkState& state) { restingWorldTick(state, false); });
+
+	// Full server steps of bodies falling onto a floor, including the collision events. Built with
+	// GAME_ENGINE_COUNT_ALLOCATIONS, it shows whether a step still allocates once the world has settled.
+	auto serverStep = [](BenchmarkState& state, int threads) {
+		auto bodies = makeBodies(state.entities());
+		int worldSize = std::max(200, static_cast<int>(std::sqrt(static_cast<double>(state.entities())) * 100));
+		std::unique_ptr<Entity> floor(new Entity(Position(-100, static_cast<float>(worldSize)), Size(static_cast<float>(worldSize + 200), 50)));
+		floor->setEntityType(EntityType::FIXED);
+
+		PhysicsSystem physicsSystem;
+		std::map<int, Entity*> clientMap;
+		GameEngine engine("Benchmark", 0, 0, Mode::SERVER);
+		engine.setPhysicsSystem(&physicsSystem);
+		std::vector<Entity*> world = pointers(bodies);
+		world.push_back(floor.get());
+		engine.initialize(world);
+		engine.setClientMap(clientMap);
+		for (auto& body : bodies) physicsSystem.addEntity(*body);
+		engine.classifyEntities();
+		engine.setSimulationThreads(threads);
+
+		for (int i = 0; i < 100; i++) engine.step();
+		while (state.keepRunning()) engine.step();
+	};
+	harness.add("GameEngine::step (server)", [serverStep](BenchmarkState& state) { serverStep(state, 0); });
+	harness.add("GameEngine::step (server, all cores)", [serverStep](BenchmarkState& state) {
+		serverStep(state, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+	});
+
+	harness.add("EventManager::process", [](BenchmarkState& state) {
+		auto bodies = makeBodies(2);
+		Timeline timeline;
+		EventManager eventManager(&timeline);
+
+		while (state.keepRunning()) {
+			state.pauseTiming();
+			for (int i = 0; i < state.entities(); i++) {
+				eventManager.raiseEvent(new CollisionEvent(bodies[0].get(), bodies[1].get()));
+			}
+			state.resumeTiming();
+
+			eventManager.process();
+		}
+	});
+
+	harness.add("Server::buildEntityUpdateMessage", [](BenchmarkState& state) {
+		auto bodies = makeBodies(state.entities());
+		std::vector<Entity*> entities = pointers(bodies);
+
+		while (state.keepRunning()) {
+			std::string message = Server::buildEntityUpdateMessage(entities);
+		}
+	});
+
+	// Alternates between two snapshots in which every body moved, so every update changes its entity
+	auto applyEntityUpdates = [](BenchmarkState& state, bool updateEvents) {
+		auto bodies = makeBodies(state.entities());
+		std::string messages[2];
+		messages[0] = Server::buildEntityUpdateMessage(pointers(bodies));
+		for (auto& body : bodies) body->setOriginalPosition(Position(body->getOriginalPosition().x + 1, body->getOriginalPosition().y));
+		messages[1] = Server::buildEntityUpdateMessage(pointers(bodies));
+
+		auto replicas = makeBodies(state.entities());
+		Client client;
+		for (auto& replica : replicas) client.getEntities().push_back(replica.get());
+		client.setUpdateEventsEnabled(updateEvents);
+
+		Timeline timeline;
+		EventManager eventManager(&timeline);
+
+		for (int i = 0; state.keepRunning(); i++) {
+			client.applyEntityUpdates(messages[i % 2], &eventManager);
+
+			state.pauseTiming();
+			eventManager.process();
+			state.resumeTiming();
+		}
+	};
+	harness.add("Client::applyEntityUpdates", [applyEntityUpdates](BenchmarkState& state) { applyEntityUpdates(state, false); });
+	harness.add("Client::applyEntityUpdates (events)", [applyEntityUpdates](BenchmarkState& state) { applyEntityUpdates(state, true); });
+
+	harness.add("WorldBlob::decode", [](BenchmarkState& state) {
+		auto bodies = makeBodies(state.entities());
+		std::vector<const Entity*> entities(bodies.size());
+		std::transform(bodies.begin(), bodies.end(), entities.begin(), [](const std::unique_ptr<Entity>& body) { return body.get(); });
+		std::string blob = WorldBlob::encode(entities);
+
+		std::vector<Entity*> decoded;
+		while (state.keepRunning()) {
+			WorldBlob::decode(blob.data(), blob.size(), decoded);
+
+			state.pauseTiming();
+			for (Entity* entity : decoded) delete entity;
+			decoded.clear();
+			state.resumeTiming();
+		}
+	});
+
+	// The entity count is used as the number of key bindings, capped by the number of scancodes
+	harness.add("InputManager::process", [](BenchmarkState& state) {
+		InputManager inputManager(false);
+		int bindings = std::min(state.entities(), static_cast<int>(SDL_NUM_SCANCODES) - 4);
+		for (int i = 0; i < bindings; i++) {
+			inputManager.bind({ static_cast<SDL_Scancode>(i + 4) });
+		}
+
+		Timeline timeline;
+		EventManager eventManager(&timeline);
+
+		while (state.keepRunning()) {
+			inputManager.process(&eventManager);
+		}
+	});
+
+	harness.addFixed("Timeline::getTime", [](BenchmarkState& state) {
+		Timeline timeline;
+		int64_t sink = 0;
+		state.setItemsPerIteration(1000);
+
+		while (state.keepRunning()) {
+			for (int i = 0; i < 1000; i++) {
+				sink += timeline.getTime();
+			}
+		}
+		if (sink == 42) printf("\n");                                  // Keeps the calls from being optimized out
+	});
+
+	harness.addFixed("Timeline::getTime (anchored)", [](BenchmarkState& state) {
+		Timeline global;
+		Timeline local(&global, 1, TimelineType::Local);
+		int64_t sink = 0;
+		state.setItemsPerIteration(1000);
+
+		while (state.keepRunning()) {
+			for (int i = 0; i < 1000; i++) {
+				sink += local.getTime();
+			}
+		}
+		if (sink == 42) printf("\n");
+	});
+
+	// Reads an anchored timeline while other threads read it too and the speed is changed now and then
+	harness.addFixed("Timeline::getTime (contended)", [](BenchmarkState& state) {
+		Timeline global;
+		Timeline local(&global, 1, TimelineType::Local);
+		std::atomic<bool> stop{ false };
+		std::atomic<int64_t> sink{ 0 };
+
+		int readers = std::max(3, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+		std::vector<std::thread> threads;
+		for (int i = 0; i < readers; i++) {
+			threads.emplace_back([&local, &stop, &sink]() {
+				int64_t sum = 0;
+				while (!stop.load(std::memory_order_relaxed)) sum += local.getTime();
+				sink += sum;
+			});
+		}
+
+		state.setItemsPerIteration(1000);
+		int iteration = 0;
+		while (state.keepRunning()) {
+			if (++iteration % 16 == 0) local.setSpeed(iteration % 32 == 0 ? 1.0 : 2.0);
+
+			int64_t sum = 0;
+			for (int i = 0; i < 1000; i++) {
+				sum += local.getTime();
+			}
+			sink += sum;
+		}
+
+		stop = true;
+		for (std::thread& thread : threads) thread.join();
+		if (sink == 42) printf("\n");
+	});
+
+	return harness.run();
+}
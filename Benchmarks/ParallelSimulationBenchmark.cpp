@@ -0,0 +1,75 @@
+#include "GameEngine.h"
+#include "Entity.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <thread>
+
+// Builds a large sparse world of moving bodies with a few fixed platforms
+static std::vector<std::unique_ptr<Entity>> makeWorld(int bodies, float worldSize) {
+	std::vector<std::unique_ptr<Entity>> entities;
+
+	for (int i = 0; i < 20; i++) {
+		Entity* platform = new Entity(Position(0, worldSize * i / 20), Size(worldSize, 50));
+		platform->setEntityType(EntityType::FIXED);
+		entities.emplace_back(platform);
+	}
+
+	srand(42);
+	for (int i = 0; i < bodies; i++) {
+		Position position(static_cast<float>(rand() % static_cast<int>(worldSize)), static_cast<float>(rand() % static_cast<int>(worldSize)));
+		entities.emplace_back(new Entity(position, Size(20, 20)));
+	}
+
+	return entities;
+}
+
+// Measures the server tick time of one large world simulated on 1 to N threads.
+// Usage: ParallelSimulationBenchmark [max threads] [bodies] [ticks]
+int main(int argc, char** argv) {
+	int maxThreads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	int bodies = argc > 2 ? std::atoi(argv[2]) : 50000;
+	int ticks = argc > 3 ? std::atoi(argv[3]) : 50;
+	float worldSize = 20000;
+
+	printf("bodies=%d world=%.0fx%.0f ticks=%d\n", bodies, worldSize, worldSize, ticks);
+	printf("%8s %14s %10s\n", "threads", "tick (ms)", "speedup");
+
+	double baseline = 0;
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		std::vector<std::unique_ptr<Entity>> world = makeWorld(bodies, worldSize);
+		std::map<int, Entity*> clientMap;
+
+		GameEngine engine("Parallel simulation benchmark", 0, 0, Mode::SERVER);
+		std::vector<Entity*> noEntities;
+		engine.initialize(noEntities);
+		engine.setClientMap(clientMap);
+
+		for (auto& entity : world) {
+			engine.addEntity(entity.get());
+			if (entity->getEntityType() != EntityType::FIXED) {
+				engine.getPhysicsSystem()->applyPhysics(*entity, 0, Velocity(static_cast<float>(rand() % 7 - 3), static_cast<float>(rand() % 7 - 3)));
+			}
+		}
+
+		// The single-threaded run also goes through the spatial partition; the serial
+		// all-pairs collision check does not finish in reasonable time at this size
+		engine.setSimulationThreads(threads);
+
+		engine.step();                                                  // Warm-up, sizes the partition buffers
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ticks; i++) {
+			engine.step();
+		}
+		double tickMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ticks;
+
+		if (threads == 1) baseline = tickMs;
+		printf("%8d %14.2f %10.2f\n", threads, tickMs, baseline / tickMs);
+
+		engine.getPhysicsSystem()->shutdown();
+	}
+
+	return 0;
+}
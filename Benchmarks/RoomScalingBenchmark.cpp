@@ -0,0 +1,75 @@
+#include "GameEngine.h"
+#include "Entity.h"
+#include "Room.h"
+#include "RoomScheduler.h"
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+// Builds a headless world with a spawn zone, a platform and a number of moving bodies
+static WorldBuilder makeWorld(int bodies) {
+	return [bodies](GameEngine& engine) {
+		std::vector<Entity*> entities;
+
+		Entity* spawnPoint = new Entity(Position(0, 100), Size(200, 200));
+		spawnPoint->setEntityType(EntityType::GHOST);
+		spawnPoint->setZoneType(ZoneType::SPAWN);
+		entities.push_back(spawnPoint);
+
+		Entity* platform = new Entity(Position(0, 1000), Size(1920, 50));
+		platform->setEntityType(EntityType::FIXED);
+		entities.push_back(platform);
+
+		for (int i = 0; i < bodies; i++) {
+			Entity* body = new Entity(Position(static_cast<float>((i * 97) % 1800), static_cast<float>((i * 53) % 900)), Size(20, 20));
+			engine.getPhysicsSystem()->applyPhysics(*body, 0, Velocity(static_cast<float>(i % 7 - 3), static_cast<float>(i % 5 - 2)));
+			entities.push_back(body);
+		}
+
+		return entities;
+	};
+}
+
+// Measures how many rooms a fixed pool of simulation threads can keep at the target tick rate.
+// Usage: RoomScalingBenchmark [threads] [bodies per room] [tick rate] [seconds per step]
+int main(int argc, char** argv) {
+	int threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	int bodies = argc > 2 ? std::atoi(argv[2]) : 50;
+	int tickRate = argc > 3 ? std::atoi(argv[3]) : 60;
+	int seconds = argc > 4 ? std::atoi(argv[4]) : 2;
+
+	printf("threads=%d bodies/room=%d tick rate=%d Hz\n", threads, bodies, tickRate);
+	printf("%8s %12s %12s %10s %12s\n", "rooms", "ticks/s", "target/s", "late %", "busy %");
+
+	int maxRoomsOnTime = 0;
+	for (int rooms = threads; rooms <= threads * 256; rooms *= 2) {
+		std::vector<std::unique_ptr<Room>> hosted;
+		RoomScheduler scheduler(threads);
+		scheduler.setTickInterval(std::chrono::nanoseconds(1'000'000'000 / tickRate));
+
+		for (int i = 0; i < rooms; i++) {
+			hosted.emplace_back(new Room(i, makeWorld(bodies)));
+			scheduler.addRoom(hosted.back().get());
+		}
+
+		scheduler.start();
+		std::this_thread::sleep_for(std::chrono::seconds(seconds));
+		scheduler.stop();
+
+		double ticksPerSecond = static_cast<double>(scheduler.getTickCount()) / seconds;
+		double target = static_cast<double>(rooms) * tickRate;
+		uint64_t iterations = scheduler.getTickCount() / std::max(1, rooms / threads);
+		double latePercent = iterations ? 100.0 * scheduler.getLateTickCount() / iterations : 0.0;
+		double busyPercent = 100.0 * scheduler.getBusyTimeNs() / (static_cast<double>(seconds) * 1e9 * threads);
+
+		printf("%8d %12.0f %12.0f %10.1f %12.1f\n", rooms, ticksPerSecond, target, latePercent, busyPercent);
+
+		// A room count is sustainable while the threads keep up with the target rate
+		if (ticksPerSecond < target * 0.95) break;
+		maxRoomsOnTime = rooms;
+	}
+
+	printf("Sustained rooms per core at %d Hz: %.1f\n", tickRate, static_cast<double>(maxRoomsOnTime) / threads);
+	return 0;
+}
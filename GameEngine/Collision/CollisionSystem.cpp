@@ -1,96 +1,364 @@
 #include  "CollisionSystem.h"
 #include  "CollisionEvent.cpp"
 #include  "DeathEvent.cpp"
+#include  "Profiler.h"
 
-#include <functional>
-#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <utility>
 
-#ifdef __APPLE__
-#include <SDL2/SDL.h>
-#else
-#include <SDL/SDL.h>
-#endif
+// Rectangles and textured entities collide as the integer rectangles they are drawn as. Circles are centered
+// on their position; triangles stand on their position with the apex above the middle of the base.
+CollisionSystem::Shape CollisionSystem::shapeOf(const Entity& entity) {
+    Shape shape;
+    Position position = entity.getOriginalPosition();
 
-// Helper function to convert a rectangle entity to a SDL_Rect
-const std::function<const SDL_Rect*(const Entity&)> to_rect = [](const Entity& entity) {
-    auto* rect = new SDL_Rect{
-        static_cast<int>(entity.getOriginalPosition().x), static_cast<int>(entity.getOriginalPosition().y),
-        static_cast<int>(entity.getSize().width), static_cast<int>(entity.getSize().height)
-    };
-    return rect;
-};
+    switch (entity.getShapeType()) {
+    case ShapeType::RECTANGLE:
+    case ShapeType::TEXTURE: {
+        int x = static_cast<int>(position.x);
+        int y = static_cast<int>(position.y);
+        int width = static_cast<int>(entity.getSize().width);
+        int height = static_cast<int>(entity.getSize().height);
+        if (width <= 0 || height <= 0) break;
 
-bool CollisionSystem::hasCollisionRaw(const Entity *entityA, const Entity *entityB) {
-    if (entityA->getShapeType() != ShapeType::RECTANGLE || entityB->getShapeType() != ShapeType::RECTANGLE) {
-        throw std::runtime_error("Unsupported entity types for collision detection");
+        shape = { ShapeType::RECTANGLE, static_cast<float>(x), static_cast<float>(y), static_cast<float>(x + width), static_cast<float>(y + height) };
+        break;
     }
+    case ShapeType::CIRCLE: {
+        float radius = entity.getCircleRadius();
+        if (radius <= 0) break;
 
-    const SDL_Rect* rectA = to_rect(*entityA);
-    const SDL_Rect* rectB = to_rect(*entityB);
+        shape = { ShapeType::CIRCLE, position.x - radius, position.y - radius, position.x + radius, position.y + radius };
+        break;
+    }
+    case ShapeType::TRIANGLE: {
+        float base = entity.getTriangleBaseLength();
+        float height = entity.getTriangleHeight();
+        if (base <= 0 || height <= 0) break;
 
-    return SDL_HasIntersection(rectA, rectB);
+        shape = { ShapeType::TRIANGLE, position.x, position.y - height, position.x + base, position.y };
+        break;
+    }
+    default:
+        break;
+    }
+    return shape;
 }
 
-bool CollisionSystem::hasCollision(const Entity *entityA, const Entity *entityB) {
-    if (entityA->getShapeType() != ShapeType::RECTANGLE || entityB->getShapeType() != ShapeType::RECTANGLE) {
-        throw std::runtime_error("Unsupported entity types for collision detection");
+// Corners of a rectangle or triangle shape, returns their count
+static int verticesOf(const CollisionSystem::Shape& shape, Position vertices[4]) {
+    if (shape.type == ShapeType::TRIANGLE) {
+        vertices[0] = Position(shape.minX, shape.maxY);
+        vertices[1] = Position(shape.maxX, shape.maxY);
+        vertices[2] = Position((shape.minX + shape.maxX) / 2, shape.minY);
+        return 3;
     }
 
-    if (entityA->getEntityType() == EntityType::GHOST || entityB->getEntityType() == EntityType::GHOST) {
+    vertices[0] = Position(shape.minX, shape.minY);
+    vertices[1] = Position(shape.maxX, shape.minY);
+    vertices[2] = Position(shape.maxX, shape.maxY);
+    vertices[3] = Position(shape.minX, shape.maxY);
+    return 4;
+}
+
+// Whether one of the edge normals of polygon 'a' separates the polygons (separating axis theorem)
+static bool separatedByEdges(const Position* a, int countA, const Position* b, int countB) {
+    for (int i = 0; i < countA; i++) {
+        const Position& from = a[i];
+        const Position& to = a[(i + 1) % countA];
+        float normalX = from.y - to.y;
+        float normalY = to.x - from.x;
+
+        float minA = std::numeric_limits<float>::max(), maxA = std::numeric_limits<float>::lowest();
+        float minB = minA, maxB = maxA;
+        for (int k = 0; k < countA; k++) {
+            float projection = a[k].x * normalX + a[k].y * normalY;
+            minA = std::min(minA, projection);
+            maxA = std::max(maxA, projection);
+        }
+        for (int k = 0; k < countB; k++) {
+            float projection = b[k].x * normalX + b[k].y * normalY;
+            minB = std::min(minB, projection);
+            maxB = std::max(maxB, projection);
+        }
+        if (maxA <= minB || maxB <= minA) return true;
+    }
+    return false;
+}
+
+static bool polygonsOverlap(const CollisionSystem::Shape& a, const CollisionSystem::Shape& b) {
+    Position verticesA[4], verticesB[4];
+    int countA = verticesOf(a, verticesA);
+    int countB = verticesOf(b, verticesB);
+    return !separatedByEdges(verticesA, countA, verticesB, countB) && !separatedByEdges(verticesB, countB, verticesA, countA);
+}
+
+static float squaredDistanceToSegment(float x, float y, const Position& from, const Position& to) {
+    float edgeX = to.x - from.x, edgeY = to.y - from.y;
+    float t = std::max(0.0f, std::min(((x - from.x) * edgeX + (y - from.y) * edgeY) / (edgeX * edgeX + edgeY * edgeY), 1.0f));
+    float dx = x - (from.x + t * edgeX), dy = y - (from.y + t * edgeY);
+    return dx * dx + dy * dy;
+}
+
+static bool circleOverlaps(const CollisionSystem::Shape& circle, const CollisionSystem::Shape& other) {
+    float radius = (circle.maxX - circle.minX) / 2;
+    float x = circle.minX + radius;
+    float y = circle.minY + radius;
+
+    switch (other.type) {
+    case ShapeType::CIRCLE: {
+        float otherRadius = (other.maxX - other.minX) / 2;
+        float dx = other.minX + otherRadius - x, dy = other.minY + otherRadius - y;
+        return dx * dx + dy * dy < (radius + otherRadius) * (radius + otherRadius);
+    }
+    case ShapeType::RECTANGLE: {
+        float dx = x - std::max(other.minX, std::min(x, other.maxX));
+        float dy = y - std::max(other.minY, std::min(y, other.maxY));
+        return dx * dx + dy * dy < radius * radius;
+    }
+    case ShapeType::TRIANGLE: {
+        Position vertices[4];
+        verticesOf(other, vertices);
+
+        // The center is inside if it is on the same side of every edge
+        bool negative = false, positive = false;
+        for (int i = 0; i < 3; i++) {
+            const Position& from = vertices[i];
+            const Position& to = vertices[(i + 1) % 3];
+            float side = (to.x - from.x) * (y - from.y) - (to.y - from.y) * (x - from.x);
+            negative |= side < 0;
+            positive |= side > 0;
+        }
+        if (!(negative && positive)) return true;
+
+        for (int i = 0; i < 3; i++) {
+            if (squaredDistanceToSegment(x, y, vertices[i], vertices[(i + 1) % 3]) < radius * radius) return true;
+        }
         return false;
     }
+    default:
+        return false;
+    }
+}
 
-    // Helper function to detect if an entity is not moving
-    const std::function<bool(const Entity&)> is_not_moving = [](const Entity& entity) {
-        return entity.getEntityType() == EntityType::FIXED || (entity.getVelocityX() == 0 && entity.getVelocityY() == 0);
-    };
+bool CollisionSystem::overlaps(const Shape& a, const Shape& b) {
+    if (a.type == ShapeType::NONE || b.type == ShapeType::NONE) return false;
+    if (a.maxX <= b.minX || b.maxX <= a.minX || a.maxY <= b.minY || b.maxY <= a.minY) return false;
+
+    if (a.type == ShapeType::RECTANGLE && b.type == ShapeType::RECTANGLE) return true;
+    if (a.type == ShapeType::CIRCLE) return circleOverlaps(a, b);
+    if (b.type == ShapeType::CIRCLE) return circleOverlaps(b, a);
+    return polygonsOverlap(a, b);
+}
 
-    if (is_not_moving(*entityB) && !is_not_moving(*entityA)) {
-        // Ensure that a fixed entity is used as the first param
-        return hasCollision(entityB, entityA);
+bool CollisionSystem::hasCollisionRaw(const Entity *entityA, const Entity *entityB) {
+    return overlaps(shapeOf(*entityA), shapeOf(*entityB));
+}
+
+// Entry and exit time of a moving interval [start, start + length] crossing [obstacle, obstacle + obstacleLength]
+static void slab(float start, float length, float delta, float obstacle, float obstacleLength, float& entry, float& exit) {
+    if (delta == 0) {
+        bool overlaps = start < obstacle + obstacleLength && start + length > obstacle;
+        entry = overlaps ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::infinity();
+        exit = std::numeric_limits<float>::infinity();
+        return;
     }
 
-    if (is_not_moving(*entityA)) {
-        // If one of the entities is fixed, and the other entity has opposing movements, then it is not technically a collision.
-        // In other words, the entities are moving away from a collision
+    float near = delta > 0 ? obstacle - (start + length) : obstacle + obstacleLength - start;
+    float far = delta > 0 ? obstacle + obstacleLength - start : obstacle - (start + length);
+    entry = near / delta;
+    exit = far / delta;
+}
+
+CollisionSystem::Impact CollisionSystem::sweep(const Entity& mover, float dx, float dy, const Entity& obstacle) {
+    Impact impact;
+    Shape shape = shapeOf(mover);
+    Shape obstacleShape = shapeOf(obstacle);
+    if (shape.type == ShapeType::NONE || obstacleShape.type == ShapeType::NONE) return impact;
+
+    float entryX, exitX, entryY, exitY;
+    slab(shape.minX, shape.maxX - shape.minX, dx, obstacleShape.minX, obstacleShape.maxX - obstacleShape.minX, entryX, exitX);
+    slab(shape.minY, shape.maxY - shape.minY, dy, obstacleShape.minY, obstacleShape.maxY - obstacleShape.minY, entryY, exitY);
+
+    float entry = std::max(entryX, entryY);
+    float exit = std::min(exitX, exitY);
+    if (entry < 0 || entry > 1 || entry >= exit) return impact;
+
+    impact.time = entry;
+    impact.xAxis = entryX > entryY;
+    return impact;
+}
 
-        if (entityB->getAccelerationY() * entityB->getVelocityY() < 0) {
+bool CollisionSystem::hasCollision(const Entity *entityA, const Entity *entityB) {
+    return hasCollision(*entityA, shapeOf(*entityA), *entityB, shapeOf(*entityB));
+}
+
+// Whether an entity is fixed or standing still
+static bool isNotMoving(const Entity& entity) {
+    return entity.getEntityType() == EntityType::FIXED || (entity.getVelocityX() == 0 && entity.getVelocityY() == 0);
+}
+
+bool CollisionSystem::hasCollision(const Entity& entityA, const Shape& shapeA, const Entity& entityB, const Shape& shapeB) {
+    if (entityA.getEntityType() == EntityType::GHOST || entityB.getEntityType() == EntityType::GHOST) {
+        return false;
+    }
+
+    // If one of the entities is not moving, and the other entity has opposing movements, then it is not technically a collision.
+    // In other words, the entities are moving away from a collision
+    const Entity* moving = nullptr;
+    if (isNotMoving(entityA)) moving = &entityB;
+    else if (isNotMoving(entityB)) moving = &entityA;
+
+    if (moving) {
+        if (moving->getAccelerationY() * moving->getVelocityY() < 0) {
             return false;
         }
 
-        if (entityB->getAccelerationX() * entityB->getVelocityX() < 0) {
+        if (moving->getAccelerationX() * moving->getVelocityX() < 0) {
             return false;
         }
     }
 
-    return SDL_HasIntersection(to_rect(*entityA), to_rect(*entityB));
+    return overlaps(shapeA, shapeB);
 }
 
-std::set<Entity*> CollisionSystem::run(const std::vector<Entity*>& entities, EventManager* eventManager) {
-    std::set<Entity*> collisions;
+void CollisionSystem::run(const std::vector<Entity*>& entities, EventManager* eventManager) {
+    PROFILE_ZONE("CollisionSystem::run");
+    _pairsTested += entities.size() * (entities.size() - (entities.empty() ? 0 : 1)) / 2;
+
+    static thread_local std::vector<Shape> shapes;
+    shapes.clear();
+    for (Entity* entity : entities) {
+        shapes.push_back(shapeOf(*entity));
+        entity->setColliding(false);
+    }
 
-    for (int i = 0; i < entities.size(); i++) {
-        for (int j = i + 1; j < entities.size(); j++) {
-            try {
-                Entity* entityA = entities.at(i); 
-                Entity* entityB = entities.at(j);
+    for (size_t i = 0; i < entities.size(); i++) {
+        for (size_t j = i + 1; j < entities.size(); j++) {
+            Entity* entityA = entities[i];
+            Entity* entityB = entities[j];
 
-                if (getInstance().hasCollision(entityA, entityB)) {
-                    // Raising a collision event
-                    eventManager->raiseEvent(new CollisionEvent(entityA, entityB));
+            if (hasCollision(*entityA, shapes[i], *entityB, shapes[j])) {
+                // Raising a collision event
+                eventManager->raiseEvent(new CollisionEvent(entityA, entityB));
 
-                    collisions.insert(entityA);
-                    collisions.insert(entityB);
-                }
-            }
-            // Skip iteration if indices are out of bounds. This can happen if a client disconnects
-            catch (const std::out_of_range&) {
-                continue; 
+                entityA->setColliding(true);
+                entityB->setColliding(true);
             }
         }
     }
+}
+
+// Contacts found by one thread, merged once all threads finished
+struct ContactBuffer {
+    std::vector<std::pair<int, int>> contacts;
+    std::vector<uint64_t> collided;                          // Bit per entity index
+    std::vector<int> nearby;
+    uint64_t pairsTested = 0;
+
+    void reset(size_t entityCount) {
+        contacts.clear();
+        collided.assign((entityCount + 63) / 64, 0);
+        pairsTested = 0;
+    }
+    void add(int first, int second) {
+        contacts.emplace_back(first, second);
+        collided[first / 64] |= uint64_t(1) << (first % 64);
+        collided[second / 64] |= uint64_t(1) << (second % 64);
+    }
+};
+
+static const size_t PARALLEL_MIN_ENTITIES = 256;          // Fewer awake entities are not worth a fork and join
+
+void CollisionSystem::run(const std::vector<Entity*>& entities, StaticIndex& staticIndex, EventManager* eventManager, ThreadPool* threadPool) {
+    PROFILE_ZONE("CollisionSystem::run");
+
+    // Scratch buffers of the calling thread, since worlds simulated side by side share this system. Workers
+    // get references, as their own thread_local instances would be different ones.
+    static thread_local std::vector<ContactBuffer> threadBuffers;
+    static thread_local std::vector<int> awakeIndices;
+    static thread_local std::vector<Shape> entityShapes;
+    std::vector<ContactBuffer>& buffers = threadBuffers;
+    std::vector<int>& awake = awakeIndices;
+    std::vector<Shape>& shapes = entityShapes;
+    awake.clear();
+    shapes.clear();
+
+    staticIndex.update(entities);
+    for (const Entity* entity : entities) shapes.push_back(shapeOf(*entity));
+    const std::vector<int>& dynamic = staticIndex.getDynamicIndices();
+    for (int i : dynamic) {
+        if (!entities[i]->isAsleep()) awake.push_back(i);
+    }
+
+    bool parallel = threadPool && threadPool->getThreadCount() > 1 && awake.size() >= PARALLEL_MIN_ENTITIES;
+    size_t threadCount = parallel ? static_cast<size_t>(threadPool->getThreadCount()) : 1;
+    if (buffers.size() < threadCount) buffers.resize(threadCount);
+    for (size_t thread = 0; thread < threadCount; thread++) buffers[thread].reset(entities.size());
+
+    // Only awake entities are paired: with every sleeping entity, with the awake ones after them, and with
+    // the static entities near them. Two sleeping entities are never tested.
+    auto detect = [&entities, &dynamic, &shapes, &staticIndex](int i, ContactBuffer& buffer) {
+        for (int j : dynamic) {
+            if (j == i || (j < i && !entities[j]->isAsleep())) continue;
+
+            buffer.pairsTested++;
+            int first = std::min(i, j);
+            int second = std::max(i, j);
+            if (hasCollision(*entities[first], shapes[first], *entities[second], shapes[second])) buffer.add(first, second);
+        }
+
+        const Shape& shape = shapes[i];
+        if (entities[i]->getEntityType() == EntityType::GHOST || shape.type == ShapeType::NONE) return;
+        staticIndex.query(shape.minX, shape.minY, shape.maxX, shape.maxY, buffer.nearby);
+
+        for (int j : buffer.nearby) {
+            buffer.pairsTested++;
+            int first = std::min(i, j);
+            int second = std::max(i, j);
+            if (hasCollision(*entities[first], shapes[first], *entities[second], shapes[second])) buffer.add(first, second);
+        }
+    };
+
+    if (parallel) {
+        size_t chunkCount = threadCount * 4;
+        size_t chunkSize = (awake.size() + chunkCount - 1) / chunkCount;
+        threadPool->parallelFor(chunkCount, [&awake, &buffers, &detect, chunkSize](size_t chunk, size_t threadIndex) {
+            PROFILE_ZONE("CollisionSystem::detect");
+            size_t end = std::min(awake.size(), (chunk + 1) * chunkSize);
+            for (size_t k = chunk * chunkSize; k < end; k++) detect(awake[k], buffers[threadIndex]);
+        });
+    }
+    else {
+        for (int i : awake) detect(i, buffers[0]);
+    }
+
+    // Merge phase: the contacts of all threads in the order of the all-pairs loop, so events are the same
+    // for any number of threads
+    ContactBuffer& merged = buffers[0];
+    for (size_t thread = 1; thread < threadCount; thread++) {
+        const ContactBuffer& buffer = buffers[thread];
+        merged.contacts.insert(merged.contacts.end(), buffer.contacts.begin(), buffer.contacts.end());
+        for (size_t word = 0; word < merged.collided.size(); word++) merged.collided[word] |= buffer.collided[word];
+        merged.pairsTested += buffer.pairsTested;
+    }
+    _pairsTested += merged.pairsTested;
+    std::sort(merged.contacts.begin(), merged.contacts.end());
+
+    for (size_t index = 0; index < entities.size(); index++) {
+        entities[index]->setColliding((merged.collided[index / 64] >> (index % 64)) & 1);
+    }
 
-    return collisions;
+    // A contact wakes sleeping entities
+    for (const auto& [first, second] : merged.contacts) {
+        Entity* entityA = entities[first];
+        Entity* entityB = entities[second];
+        if (entityA->isAsleep()) entityA->wake();
+        if (entityB->isAsleep()) entityB->wake();
+
+        eventManager->raiseEvent(new CollisionEvent(entityA, entityB));
+    }
 }
 
 void CollisionSystem::handleCollision(Entity *entity) {
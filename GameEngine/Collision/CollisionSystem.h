@@ -1,10 +1,12 @@
 #pragma once
 
-#include <set>
+#include <atomic>
 #include <map>
 #include <vector>
 #include "Entity.h"
 #include "EventManager.h"
+#include "StaticIndex.h"
+#include "ThreadPool.h"
 
 // A singleton class that handles collisions between game entities
 class CollisionSystem {
@@ -17,20 +19,56 @@ public:
     CollisionSystem(const CollisionSystem&) = delete;         // Preventing copying
     void operator=(const CollisionSystem) = delete;         // Preventing assignmenet
 
-    // Detect collisions between entities and apply physics, also returns a set of entities for which a collision was detected
-    std::set<Entity*> run(const std::vector<Entity*>& entities, EventManager* eventManager);
+    // Detect collisions between entities and raise collision events. Flags every entity in the list as colliding
+    // or not (see Entity::isColliding).
+    void run(const std::vector<Entity*>& entities, EventManager* eventManager);
+    // Same as above, but only tests dynamic entities against each other and against the static entities near
+    // them (see StaticIndex). Updates 'staticIndex'. Events are raised in the same order as above. With a thread
+    // pool the pairs are tested on all its threads; contacts are merged before any event is raised, so events
+    // and results do not depend on the number of threads.
+    void run(const std::vector<Entity*>& entities, StaticIndex& staticIndex, EventManager* eventManager, ThreadPool* threadPool = nullptr);
+
+    // Collision shape of an entity in world coordinates: its type (RECTANGLE for textured entities, NONE for
+    // entities that cannot collide) and its axis-aligned bounds. Runs compute it once per entity, so the pair
+    // tests only compare numbers.
+    struct Shape {
+        ShapeType type = ShapeType::NONE;
+        float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    };
+    static Shape shapeOf(const Entity& entity);
+    // Whether two shapes overlap, for any pair of rectangles, circles and triangles. Touching shapes do not.
+    // Never throws or allocates.
+    static bool overlaps(const Shape& a, const Shape& b);
 
     // Helper method to detect collision between 2 entities
-    // NOTE: Currently handles only rectangle<->rectangle collisions
     bool hasCollision(const Entity* entityA, const Entity* entityB);
+    // Same as above, with the shapes of the entities already computed
+    static bool hasCollision(const Entity& entityA, const Shape& shapeA, const Entity& entityB, const Shape& shapeB);
 
+    // Whether the shapes of 2 entities overlap, regardless of their types and motion
     static bool hasCollisionRaw(const Entity* entityA, const Entity* entityB);
 
+    // Result of a swept test: the fraction of the motion at which the boxes meet (above 1 if they do not), and
+    // whether they meet on the x axis (at a side) rather than on the y axis (at the top or bottom)
+    struct Impact {
+        float time = 2.0f;
+        bool xAxis = false;
+    };
+    // Sweeps the bounds of the shape of 'mover' by (dx, dy) from its current position against the bounds of 'obstacle'.
+    // Boxes that already overlap do not meet; the discrete test handles them.
+    static Impact sweep(const Entity& mover, float dx, float dy, const Entity& obstacle);
+
+    // Number of entity pairs passed to the narrow phase since startup, across all worlds
+    uint64_t getPairsTested() const { return _pairsTested; }
+    void addPairsTested(uint64_t pairs) { _pairsTested += pairs; }
+
     // Helper method to apply physics to 2 entities that are in collision
     void handleCollision(Entity* entity);
 
 private:
     CollisionSystem() = default;
     ~CollisionSystem() = default;
+
+    std::atomic<uint64_t> _pairsTested{ 0 };
     
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "SpatialPartition.h"
+#include "CollisionSystem.h"
+#include "CollisionEvent.cpp"
+#include "Profiler.h"
+
+#include <algorithm>
+
+SpatialPartition::SpatialPartition(ThreadPool* threadPool) : _threadPool(threadPool) {}
+
+// Sorts the collidable dynamic entities by their left edge and deals them out to regions of equal size.
+// Entities overlapping the regions to their right are copied there as ghosts.
+void SpatialPartition::buildRegions(const std::vector<Entity*>& entities, const std::vector<int>& dynamicIndices) {
+    _bounds.clear();
+    for (int i : dynamicIndices) {
+        // Ghosts and entities without a shape never collide
+        const CollisionSystem::Shape& shape = _shapes[i];
+        if (entities[i]->getEntityType() == EntityType::GHOST || shape.type == ShapeType::NONE) continue;
+
+        _bounds.push_back({ shape.minX, shape.maxX, shape.minY, shape.maxY, i, false });
+    }
+
+    std::sort(_bounds.begin(), _bounds.end(), [](const Bounds& a, const Bounds& b) {
+        return a.minX < b.minX || (a.minX == b.minX && a.index < b.index);
+    });
+
+    size_t regionCount = std::max<size_t>(1, std::min(_bounds.size() / 2 + 1, getRegionCount()));
+    size_t perRegion = (_bounds.size() + regionCount - 1) / regionCount;
+    _regions.resize(regionCount);
+    for (auto& region : _regions) region.clear();
+
+    for (size_t i = 0; i < _bounds.size(); i++) {
+        size_t owner = perRegion ? i / perRegion : 0;
+        _regions[owner].push_back(_bounds[i]);
+
+        // Regions to the right start at the left edge of their first entity
+        Bounds ghost = _bounds[i];
+        ghost.ghost = true;
+        for (size_t region = owner + 1; region < regionCount; region++) {
+            size_t first = region * perRegion;
+            if (first >= _bounds.size() || _bounds[first].minX > ghost.maxX) break;
+            _regions[region].push_back(ghost);
+        }
+    }
+}
+
+// Sweeps the region along the y axis and tests every pair whose bounds overlap, then tests the
+// entities the region owns against the static entities near them
+void SpatialPartition::detectInRegion(size_t region, const std::vector<Entity*>& entities, const StaticIndex& staticIndex) {
+    PROFILE_ZONE("SpatialPartition::detectInRegion");
+    std::vector<Bounds>& items = _regions[region];
+    std::vector<std::pair<int, int>>& contacts = _contacts[region];
+    std::vector<int>& nearby = _nearbyStatic[region];
+    contacts.clear();
+
+    std::sort(items.begin(), items.end(), [](const Bounds& a, const Bounds& b) {
+        return a.minY < b.minY;
+    });
+
+    CollisionSystem& collisionSystem = CollisionSystem::getInstance();
+    const std::vector<CollisionSystem::Shape>& shapes = _shapes;
+    uint64_t pairsTested = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        const Bounds& a = items[i];
+        for (size_t j = i + 1; j < items.size() && items[j].minY <= a.maxY; j++) {
+            const Bounds& b = items[j];
+
+            // Pairs of ghosts are tested by the region that owns one of them
+            if (a.ghost && b.ghost) continue;
+            if (a.maxX <= b.minX || b.maxX <= a.minX) continue;
+
+            int first = std::min(a.index, b.index);
+            int second = std::max(a.index, b.index);
+            if (entities[first]->isAsleep() && entities[second]->isAsleep()) continue;
+            pairsTested++;
+            if (CollisionSystem::hasCollision(*entities[first], shapes[first], *entities[second], shapes[second])) {
+                contacts.emplace_back(first, second);
+            }
+        }
+    }
+
+    for (const Bounds& a : items) {
+        if (a.ghost || entities[a.index]->isAsleep()) continue;
+        staticIndex.query(a.minX, a.minY, a.maxX, a.maxY, nearby);
+
+        for (int index : nearby) {
+            int first = std::min(a.index, index);
+            int second = std::max(a.index, index);
+            pairsTested++;
+            if (CollisionSystem::hasCollision(*entities[first], shapes[first], *entities[second], shapes[second])) {
+                contacts.emplace_back(first, second);
+            }
+        }
+    }
+    collisionSystem.addPairsTested(pairsTested);
+}
+
+void SpatialPartition::run(const std::vector<Entity*>& entities, StaticIndex& staticIndex, EventManager* eventManager) {
+    PROFILE_ZONE("SpatialPartition::run");
+
+    staticIndex.update(entities);
+    _shapes.clear();
+    for (Entity* entity : entities) {
+        _shapes.push_back(CollisionSystem::shapeOf(*entity));
+        entity->setColliding(false);
+    }
+    buildRegions(entities, staticIndex.getDynamicIndices());
+    _contacts.resize(_regions.size());
+    _nearbyStatic.resize(_regions.size());
+
+    _threadPool->parallelFor(_regions.size(), [this, &entities, &staticIndex](size_t region, size_t) {
+        detectInRegion(region, entities, staticIndex);
+    });
+
+    // Merge phase: order contacts the way the serial pair loop would have found them
+    _merged.clear();
+    for (const auto& contacts : _contacts) {
+        _merged.insert(_merged.end(), contacts.begin(), contacts.end());
+    }
+    std::sort(_merged.begin(), _merged.end());
+
+    // A contact wakes sleeping entities
+    for (const auto& [first, second] : _merged) {
+        Entity* entityA = entities[first];
+        Entity* entityB = entities[second];
+        if (entityA->isAsleep()) entityA->wake();
+        if (entityB->isAsleep()) entityB->wake();
+
+        eventManager->raiseEvent(new CollisionEvent(entityA, entityB));
+        entityA->setColliding(true);
+        entityB->setColliding(true);
+    }
+}
+
+void SpatialPartition::setRegionsPerThread(int regionsPerThread) {
+    _regionsPerThread = std::max(1, regionsPerThread);
+}
+
+size_t SpatialPartition::getRegionCount() const {
+    return static_cast<size_t>(_threadPool->getThreadCount()) * _regionsPerThread;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "Entity.h"
+#include "EventManager.h"
+#include "CollisionSystem.h"
+#include "StaticIndex.h"
+#include "ThreadPool.h"
+
+// Splits the world into vertical regions holding roughly the same number of entities and detects
+// collisions in all regions in parallel. Each entity is owned by the region containing its left edge;
+// entities reaching into regions further right are added there as ghosts, so every overlapping pair is
+// tested by exactly one region. Contacts are buffered per region and merged in a deterministic order
+// before any event is raised, which gives the same events, in the same order, as CollisionSystem::run.
+// Only dynamic entities are partitioned; each one is tested against the static entities near it through
+// the StaticIndex by the region that owns it.
+class SpatialPartition {
+public:
+    explicit SpatialPartition(ThreadPool* threadPool);
+
+    // Detects collisions and raises collision events. Flags every entity as colliding or not (see Entity::isColliding).
+    // Updates 'staticIndex'.
+    void run(const std::vector<Entity*>& entities, StaticIndex& staticIndex, EventManager* eventManager);
+
+    void setRegionsPerThread(int regionsPerThread);
+    size_t getRegionCount() const;
+
+private:
+    // Bounds of the shape of an entity
+    struct Bounds {
+        float minX, maxX, minY, maxY;
+        int index;                                  // Index of the entity in the list passed to run
+        bool ghost;                                 // Owned by a region further left
+    };
+
+    void buildRegions(const std::vector<Entity*>& entities, const std::vector<int>& dynamicIndices);
+    void detectInRegion(size_t region, const std::vector<Entity*>& entities, const StaticIndex& staticIndex);
+
+    ThreadPool* _threadPool;
+    int _regionsPerThread = 4;
+
+    // Buffers reused across ticks
+    std::vector<CollisionSystem::Shape> _shapes;                 // Shape of every entity, by index
+    std::vector<Bounds> _bounds;
+    std::vector<std::vector<Bounds>> _regions;
+    std::vector<std::vector<std::pair<int, int>>> _contacts;     // Contacts found by each region
+    std::vector<std::vector<int>> _nearbyStatic;                 // Static entities near one entity, per region
+    std::vector<std::pair<int, int>> _merged;
+};
@@ -0,0 +1,109 @@
+#include "StaticIndex.h"
+#include "CollisionSystem.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+StaticIndex::StaticIndex(float cellSize) : _cellSize(cellSize) {}
+
+int StaticIndex::cellOf(float coordinate) const {
+    return static_cast<int>(std::floor(coordinate / _cellSize));
+}
+
+int64_t StaticIndex::cellKey(int cellX, int cellY) {
+    return (static_cast<int64_t>(cellX) << 32) | static_cast<uint32_t>(cellY);
+}
+
+// Static entities keep their place in the grid as long as they appear in the same order, so players
+// joining or leaving only shift the indices
+void StaticIndex::update(const std::vector<Entity*>& entities) {
+    PROFILE_ZONE("StaticIndex::update");
+    bool changed = _invalid.exchange(false);
+    size_t staticCount = 0;
+    _dynamicIndices.clear();
+
+    for (int i = 0; i < static_cast<int>(entities.size()); i++) {
+        Entity* entity = entities[i];
+        if (!entity->isStatic()) {
+            _dynamicIndices.push_back(i);
+            continue;
+        }
+
+        if (staticCount == _static.size()) {
+            _static.push_back(entity);
+            _staticIndices.push_back(i);
+            changed = true;
+        }
+        else {
+            changed |= _static[staticCount] != entity;
+            _static[staticCount] = entity;
+            _staticIndices[staticCount] = i;
+        }
+        staticCount++;
+    }
+
+    if (staticCount != _static.size()) {
+        _static.resize(staticCount);
+        _staticIndices.resize(staticCount);
+        changed = true;
+    }
+    if (changed) build();
+}
+
+// Files every static entity that can collide under each grid cell the bounds of its shape overlap
+void StaticIndex::build() {
+    PROFILE_ZONE("StaticIndex::build");
+    _cells.clear();
+    _buildCount++;
+
+    for (int k = 0; k < static_cast<int>(_static.size()); k++) {
+        const Entity* entity = _static[k];
+        CollisionSystem::Shape shape = CollisionSystem::shapeOf(*entity);
+        if (entity->getEntityType() == EntityType::GHOST || shape.type == ShapeType::NONE) continue;
+
+        for (int x = cellOf(shape.minX); x <= cellOf(shape.maxX); x++) {
+            for (int y = cellOf(shape.minY); y <= cellOf(shape.maxY); y++) {
+                _cells[cellKey(x, y)].push_back(k);
+            }
+        }
+    }
+}
+
+void StaticIndex::invalidate() {
+    _invalid = true;
+}
+
+void StaticIndex::collect(float minX, float minY, float maxX, float maxY, std::vector<int>& positions) const {
+    positions.clear();
+    if (_cells.empty()) return;
+
+    for (int x = cellOf(minX); x <= cellOf(maxX); x++) {
+        for (int y = cellOf(minY); y <= cellOf(maxY); y++) {
+            auto it = _cells.find(cellKey(x, y));
+            if (it == _cells.end()) continue;
+            positions.insert(positions.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // Entities spanning several cells are reported once
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+}
+
+void StaticIndex::query(float minX, float minY, float maxX, float maxY, std::vector<int>& result) const {
+    collect(minX, minY, maxX, maxY, result);
+    for (int& k : result) k = _staticIndices[k];
+}
+
+void StaticIndex::query(float minX, float minY, float maxX, float maxY, std::vector<Entity*>& result) const {
+    static thread_local std::vector<int> positions;
+    collect(minX, minY, maxX, maxY, positions);
+
+    result.clear();
+    for (int k : positions) result.push_back(_static[k]);
+}
+
+const std::vector<int>& StaticIndex::getDynamicIndices() const { return _dynamicIndices; }
+size_t StaticIndex::getStaticCount() const { return _static.size(); }
+uint64_t StaticIndex::getBuildCount() const { return _buildCount; }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Entity.h"
+
+// Splits a world into static entities (see Entity::isStatic) and dynamic ones. The static entities that can
+// collide are filed in a uniform grid that is built once and only rebuilt when static entities are added,
+// removed or reordered, or after invalidate(). Collision detection then tests dynamic entities against each
+// other and against the static entities near them, never static entities against each other.
+class StaticIndex {
+public:
+    explicit StaticIndex(float cellSize = 256.0f);
+
+    // Sorts the entities into static and dynamic ones. Indices refer to 'entities' until the next update.
+    void update(const std::vector<Entity*>& entities);
+    // Rebuilds the grid on the next update. Call after moving, resizing or retyping a static entity.
+    // Safe to call from any thread.
+    void invalidate();
+
+    // Indices of the dynamic entities, ascending
+    const std::vector<int>& getDynamicIndices() const;
+    size_t getStaticCount() const;
+    // Number of times the grid was built, for tests and statistics
+    uint64_t getBuildCount() const;
+
+    // Collects the indices of the static entities whose grid cells overlap the bounds, ascending. Callers
+    // still run the narrow phase. Safe to call from several threads at once.
+    void query(float minX, float minY, float maxX, float maxY, std::vector<int>& result) const;
+    // Same as above, but collects the entities
+    void query(float minX, float minY, float maxX, float maxY, std::vector<Entity*>& result) const;
+
+private:
+    int cellOf(float coordinate) const;
+    static int64_t cellKey(int cellX, int cellY);
+    void build();
+    // Positions in _static of the entities filed under the cells overlapping the bounds, ascending
+    void collect(float minX, float minY, float maxX, float maxY, std::vector<int>& positions) const;
+
+    float _cellSize;
+    std::vector<Entity*> _static;                                    // Static entities in world order
+    std::vector<int> _staticIndices;                                 // Index of each static entity in the world
+    std::vector<int> _dynamicIndices;
+    std::unordered_map<int64_t, std::vector<int>> _cells;            // Grid cell key to positions in _static
+    std::atomic<bool> _invalid{ true };
+    uint64_t _buildCount = 0;
+};
@@ -0,0 +1,92 @@
+#include "ZoneIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+ZoneIndex::ZoneIndex(float cellSize) : _cellSize(cellSize) {}
+
+int ZoneIndex::cellOf(float coordinate) const {
+    return static_cast<int>(std::floor(coordinate / _cellSize));
+}
+
+int64_t ZoneIndex::cellKey(int cellX, int cellY) {
+    return (static_cast<int64_t>(cellX) << 32) | static_cast<uint32_t>(cellY);
+}
+
+void ZoneIndex::clear() {
+    for (Zones& zones : _zones) {
+        zones.entities.clear();
+        zones.cells.clear();
+    }
+}
+
+// Files every zone under its type and under each grid cell its bounds overlap
+void ZoneIndex::rebuild(const std::vector<Entity*>& entities) {
+    clear();
+
+    for (Entity* entity : entities) {
+        if (entity->getZoneType() == ZoneType::NONE) continue;
+
+        Zones& zones = _zones[static_cast<size_t>(entity->getZoneType())];
+        zones.entities.push_back(entity);
+
+        Position position = entity->getOriginalPosition();
+        Size size = entity->getSize();
+        for (int x = cellOf(position.x); x <= cellOf(position.x + size.width); x++) {
+            for (int y = cellOf(position.y); y <= cellOf(position.y + size.height); y++) {
+                zones.cells[cellKey(x, y)].push_back(entity);
+            }
+        }
+    }
+}
+
+const std::vector<Entity*>& ZoneIndex::getZones(ZoneType type) const {
+    return _zones[static_cast<size_t>(type)].entities;
+}
+
+bool ZoneIndex::hasZones(ZoneType type) const {
+    return !getZones(type).empty();
+}
+
+void ZoneIndex::queryNearby(ZoneType type, const Entity& entity, std::vector<Entity*>& result) const {
+    result.clear();
+
+    const Zones& zones = _zones[static_cast<size_t>(type)];
+    if (zones.entities.empty()) return;
+
+    Position position = entity.getOriginalPosition();
+    Size size = entity.getSize();
+    for (int x = cellOf(position.x); x <= cellOf(position.x + size.width); x++) {
+        for (int y = cellOf(position.y); y <= cellOf(position.y + size.height); y++) {
+            auto it = zones.cells.find(cellKey(x, y));
+            if (it == zones.cells.end()) continue;
+
+            // Zones spanning several cells are reported once
+            for (Entity* zone : it->second) {
+                if (std::find(result.begin(), result.end(), zone) == result.end()) {
+                    result.push_back(zone);
+                }
+            }
+        }
+    }
+}
+
+// Picks a random spawn zone and generates a random position within its boundaries
+Position ZoneIndex::randomSpawnPosition(float playerSize) const {
+    const std::vector<Entity*>& spawnPoints = getZones(ZoneType::SPAWN);
+
+    // Throw an error if no spawn points are found
+    if (spawnPoints.empty()) {
+        throw std::runtime_error("No spawn points found in the world!");
+    }
+
+    Entity* spawnPoint = spawnPoints[rand() % spawnPoints.size()];
+    Position spawnPos = spawnPoint->getOriginalPosition();
+    Size spawnSize = spawnPoint->getSize();
+
+    float playerX = spawnPos.x + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (spawnSize.width - playerSize)));
+    float playerY = spawnPos.y + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (spawnSize.height - playerSize)));
+    return Position(playerX, playerY);
+}
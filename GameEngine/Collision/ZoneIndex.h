@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Entity.h"
+
+// Keeps the zone entities of a world in one list per ZoneType, each with a uniform grid for spatial
+// lookups. Zones are expected to stay in place; call rebuild after adding, removing or moving zones.
+class ZoneIndex {
+public:
+    explicit ZoneIndex(float cellSize = 256.0f);
+
+    // Indexes every zone among the entities. Entities with ZoneType::NONE are ignored.
+    void rebuild(const std::vector<Entity*>& entities);
+    void clear();
+
+    const std::vector<Entity*>& getZones(ZoneType type) const;
+    bool hasZones(ZoneType type) const;
+
+    // Collects the zones of the given type whose grid cells overlap the entity's bounds. Callers still
+    // run the exact overlap test; the result only holds zones that are near the entity.
+    void queryNearby(ZoneType type, const Entity& entity, std::vector<Entity*>& result) const;
+
+    // Picks a random spawn zone and returns a random position inside it for a player of the given size
+    Position randomSpawnPosition(float playerSize = 50.0f) const;
+
+private:
+    struct Zones {
+        std::vector<Entity*> entities;
+        std::unordered_map<int64_t, std::vector<Entity*>> cells;     // Grid cell key to zones overlapping the cell
+    };
+
+    static constexpr size_t ZONE_TYPE_COUNT = static_cast<size_t>(ZoneType::SIDESCROLL) + 1;
+
+    int cellOf(float coordinate) const;
+    static int64_t cellKey(int cellX, int cellY);
+
+    float _cellSize;
+    Zones _zones[ZONE_TYPE_COUNT];
+};
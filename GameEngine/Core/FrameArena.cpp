@@ -0,0 +1,49 @@
+#include "FrameArena.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+FrameArena::FrameArena(size_t capacity) : _capacity(std::max<size_t>(capacity, 64)) {
+	_buffer = static_cast<char*>(::operator new(_capacity));
+}
+
+FrameArena::~FrameArena() {
+	for (void* block : _overflow) ::operator delete(block);
+	::operator delete(_buffer);
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+	uintptr_t base = reinterpret_cast<uintptr_t>(_buffer);
+	uintptr_t aligned = (base + _offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+	size_t end = static_cast<size_t>(aligned - base) + bytes;
+
+	if (end <= _capacity) {
+		_offset = end;
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	// Out of room for this step; the block is remembered so the arena grows at the next reset
+	void* block = ::operator new(bytes + alignment);
+	_overflow.push_back(block);
+	_overflowBytes += bytes + alignment;
+	uintptr_t start = reinterpret_cast<uintptr_t>(block);
+	return reinterpret_cast<void*>((start + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1));
+}
+
+void FrameArena::reset() {
+	if (!_overflow.empty()) {
+		for (void* block : _overflow) ::operator delete(block);
+		_overflow.clear();
+
+		// Leaves headroom so a step that grows a little does not overflow again
+		size_t capacity = (_capacity + _overflowBytes) * 3 / 2;
+		::operator delete(_buffer);
+		_buffer = static_cast<char*>(::operator new(capacity));
+		_capacity = capacity;
+		_overflowBytes = 0;
+	}
+	_offset = 0;
+}
+
+size_t FrameArena::getUsed() const { return _offset + _overflowBytes; }
+size_t FrameArena::getCapacity() const { return _capacity; }
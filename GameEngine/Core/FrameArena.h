@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Bump allocator for scratch data that only lives for one engine step. Allocating moves an offset and
+// reset() drops everything at once; nothing is freed individually. A step that needs more than the arena
+// holds gets overflow blocks from the heap, and the next reset() grows the arena to cover them, so steps
+// of a steady size stop reaching the heap. Not thread-safe; use one arena per thread.
+class FrameArena {
+public:
+	explicit FrameArena(size_t capacity = 64 * 1024);
+	~FrameArena();
+
+	FrameArena(const FrameArena&) = delete;
+	void operator=(const FrameArena&) = delete;
+
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+	// Invalidates everything allocated since the previous reset
+	void reset();
+
+	// Bytes handed out since the previous reset
+	size_t getUsed() const;
+	size_t getCapacity() const;
+
+	// Lets standard containers use the arena (see FrameVector). Deallocating is a no-op.
+	template <typename T>
+	class Allocator {
+	public:
+		using value_type = T;
+
+		explicit Allocator(FrameArena& arena) : _arena(&arena) {}
+		template <typename U>
+		Allocator(const Allocator<U>& other) : _arena(other.getArena()) {}
+
+		T* allocate(size_t count) { return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T))); }
+		void deallocate(T*, size_t) {}
+
+		FrameArena* getArena() const { return _arena; }
+		template <typename U>
+		bool operator==(const Allocator<U>& other) const { return _arena == other.getArena(); }
+		template <typename U>
+		bool operator!=(const Allocator<U>& other) const { return _arena != other.getArena(); }
+
+	private:
+		FrameArena* _arena;
+	};
+
+private:
+	char* _buffer;
+	size_t _capacity;
+	size_t _offset = 0;
+	std::vector<void*> _overflow;                                        // Heap blocks taken since the last reset
+	size_t _overflowBytes = 0;
+};
+
+// Vector whose storage lives in a FrameArena. It must not outlive the arena's next reset.
+template <typename T>
+using FrameVector = std::vector<T, FrameArena::Allocator<T>>;
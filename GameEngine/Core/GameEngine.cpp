@@ -3,6 +3,7 @@
 #include "CollisionEvent.cpp"
 #include "DeathEvent.cpp"
 #include "EntityUpdateEvent.cpp"
+#include "Profiler.h"
 #include <iostream>
 #include <thread>
 #ifdef __APPLE__
@@ -33,15 +34,23 @@ GameEngine::GameEngine(const char* windowTitle, int windowWidth, int windowHeigh
 }
 
 GameEngine::~GameEngine() {
+	stopUpdateThread();
 	delete _renderer;
 	delete _window;
 	delete _inputManager;
+	delete _eventManager;
+	delete _replaySystem;
 	delete _timeline;
+	delete _client;
+	delete _peer;
+	delete _spatialPartition;
+	delete _threadPool;
 }
 
 // Initializes the game engine subsystems.
 bool GameEngine::initialize(std::vector<Entity*>& entities) {
 	_entities = entities;
+	assignWorldSlots();
 
 	try {
 		switch (_mode) {
@@ -57,7 +66,6 @@ bool GameEngine::initialize(std::vector<Entity*>& entities) {
 					if (!_client->handshakeWithServer()) {						
 						throw std::runtime_error("Failed to connect to the server");
 					}
-					_entities = _client->getEntities();
 				}
 				if (!_window->initialize()) {
 					throw std::runtime_error("Failed to initialize Window for Client");
@@ -110,10 +118,39 @@ bool GameEngine::initialize(std::vector<Entity*>& entities) {
 		return false;
 	}
 	
+	if (_mode == Mode::SERVER || _mode == Mode::SINGLE_PLAYER) classifyEntities();
+	_zoneIndex.rebuild(_entities);
 	setUpEventHandlers();
 	return true;
 }
 
+// Entities registered with physics stay dynamic, whatever their type
+void GameEngine::classifyEntities() {
+	for (Entity* entity : _entities) {
+		entity->setStatic(hasStaticType(*entity) && !_physicsSystem->contains(*entity));
+	}
+	_staticIndex.invalidate();
+}
+
+void GameEngine::invalidateStaticWorld() {
+	_staticIndex.invalidate();
+	_staticRevision++;
+	_staticWorldChanged = true;
+}
+
+// Dynamic entities are rescaled every frame. Static ones only when the window scale or the static world changed.
+void GameEngine::scaleEntities(float scaleX, float scaleY) {
+	uint64_t revision = _staticRevision + (_client ? _client->getStaticRevision() : 0);
+	bool rescaleStatic = scaleX != _scaledX || scaleY != _scaledY || revision != _scaledRevision;
+	_scaledX = scaleX;
+	_scaledY = scaleY;
+	_scaledRevision = revision;
+
+	for (Entity* entity : getEntities()) {
+		if (rescaleStatic || !entity->isStatic()) entity->applyScaling(scaleX, scaleY);
+	}
+}
+
 // Sets up event handlers 
 void GameEngine::setUpEventHandlers() {	
 	// Handker for collision events
@@ -121,14 +158,16 @@ void GameEngine::setUpEventHandlers() {
 		Entity* entityA = event->getEntityA();
 		Entity* entityB = event->getEntityB();
 
-		_collisionSystem->handleCollision(entityA);
-		_collisionSystem->handleCollision(entityB);
+		// Either entity may have been removed and destroyed since the collision
+		if (entityA) _collisionSystem->handleCollision(entityA);
+		if (entityB) _collisionSystem->handleCollision(entityB);
 		
 		});
 
 	// Handler for death events 
 	const EventHandler deathHandler = TypedEventHandler<DeathEvent>([this](const DeathEvent* event) {
 		Entity* entity = event->getEntity();		
+		if (!entity) return;                                   // The player left before respawning
 
 		// Set the entity's type back to default
 		entity->setEntityType(EntityType::DEFAULT);
@@ -136,41 +175,20 @@ void GameEngine::setUpEventHandlers() {
 		
 		});
 
+	// The client has already applied the update; the event only carries the changed fields for the replay
 	const EventHandler entityUpdateHandler = TypedEventHandler<EntityUpdateEvent>([this](const EntityUpdateEvent* event) {
-		const Entity* updatedEntity = event->getEntity();
-		if (_replaySystem->isReplaying() && !event->isReplay()) {
-			// Drop non-replay events if replay is in progress
-			return;
-		}
-
-		for (Entity* entity : _entities) {
-			if (entity->getZoneType() == ZoneType::SIDESCROLL) continue;
-			if (_gameState == GameState::PAUSED && entity->getEntityID() == _client->getEntityID()) continue;
-
-			if (entity->getEntityID() == updatedEntity->getEntityID()) {
-				*entity = *updatedEntity;
-				break;
-			}
-		}
-
 		if (_replaySystem->isRecording()) {			
 			_replaySystem->handler(event);
-			
 		}
 	});
 
 	const EventHandler replayHandler = TypedEventHandler<ReplayEvent>([this](const ReplayEvent *event) {
-		const Entity* updatedEntity = event->getEntity();
+		const EntityDelta& delta = event->getDelta();
+		Entity* entity = _client ? _client->findEntity(delta.id) : nullptr;
+		if (!entity || entity->getZoneType() == ZoneType::SIDESCROLL) return;
+		if (_gameState == GameState::PAUSED && delta.id == _client->getEntityID()) return;
 
-		for (Entity* entity : _entities) {
-			if (entity->getZoneType() == ZoneType::SIDESCROLL) continue;
-			if (_gameState == GameState::PAUSED && entity->getEntityID() == _client->getEntityID()) continue;
-
-			if (entity->getEntityID() == updatedEntity->getEntityID()) {
-				*entity = *updatedEntity;
-				break;
-			}
-		}
+		delta.applyTo(*entity);
 	});
 
 	// Register the handler with the event manager
@@ -180,47 +198,28 @@ void GameEngine::setUpEventHandlers() {
 	_eventManager->registerHandler(EventType::Replay, replayHandler);
 }
 
-// Handles player entity collisions with death zones
+// Handles player entity collisions with death zones. Only the death zones near each player are tested.
 void GameEngine::handleDeathZones() {
-	for (Entity* entity : _entities) {
-		if (entity->getZoneType() == ZoneType::DEATH) {
-			// Loop through all players in the client map
-			for (const auto& [clientId, playerEntity] : *_clientMap) {
-				if (_collisionSystem->hasCollisionRaw(entity, playerEntity)) {
-
-					// Find all spawn points
-					std::vector<Entity*> spawnPoints;
-					for (Entity* spawnEntity : _entities) {
-						if (spawnEntity->getZoneType() == ZoneType::SPAWN) {
-							spawnPoints.push_back(spawnEntity);
-						}
-					}
+	PROFILE_ZONE("GameEngine::handleDeathZones");
+	if (!_zoneIndex.hasZones(ZoneType::DEATH)) return;
 
-					// Error if no spawn points are found
-					if (spawnPoints.empty()) {
-						throw std::runtime_error("No spawn points found for teleportation!");
-					}
+	for (const auto& [clientId, playerEntity] : *_clientMap) {
+		_zoneIndex.queryNearby(ZoneType::DEATH, *playerEntity, _nearbyZones);
 
-					// Choose a random spawn point and calculate its center position
-					int randomIndex = rand() % spawnPoints.size();
-					Entity* spawnPoint = spawnPoints[randomIndex];
-					Position spawnPos = spawnPoint->getOriginalPosition();
-					Size spawnSize = spawnPoint->getSize();
-
-					// Generate a random position within the spawn point boundaries
-					float playerX = spawnPos.x + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (spawnSize.width - 50)));
-					float playerY = spawnPos.y + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (spawnSize.height - 50)));
-					Position newPosition(playerX, playerY);					
-
-					playerEntity->setOriginalPosition(newPosition);
-					playerEntity->setVelocityX(0);
-					playerEntity->setVelocityY(0);
-					playerEntity->setAccelerationY(0);
-					playerEntity->setEntityType(EntityType::GHOST);
-
-					// Raise a death event with delay to respawn the player
-					_eventManager->raiseEventWithDelay(new DeathEvent(playerEntity, newPosition), entity->getEventDelay());
-				}
+		for (Entity* entity : _nearbyZones) {
+			if (_collisionSystem->hasCollisionRaw(entity, playerEntity)) {
+				// Generate a random position within one of the spawn points
+				Position newPosition = _zoneIndex.randomSpawnPosition();
+
+				playerEntity->setOriginalPosition(newPosition);
+				playerEntity->setVelocityX(0);
+				playerEntity->setVelocityY(0);
+				playerEntity->setAccelerationY(0);
+				playerEntity->setEntityType(EntityType::GHOST);
+
+				// Raise a death event with delay to respawn the player
+				_eventManager->raiseEventWithDelay(new DeathEvent(playerEntity, newPosition), entity->getEventDelay());
+				break;
 			}
 		}
 	}
@@ -253,34 +252,11 @@ void GameEngine::moveCamera(int newX, int newY) {
 
 // Game loop. Runs while the state is 'PLAY'.
 void GameEngine::run() {
-	int64_t previousTime = _timeline->getTime();
-	int64_t currentTime;
-	int sleepDurationMs = 0;
+	PROFILE_THREAD("Engine loop");
+	_previousTime = _timeline->getTime();
 
 	while (_gameState != GameState::EXIT) {
-		
-		currentTime = _timeline->getTime();
-		int64_t elapsedTime = currentTime - previousTime;
-		previousTime = currentTime;
-		
-		switch (_mode) {
-		case Mode::SERVER:
-			handleServerMode(elapsedTime);
-			sleepDurationMs = getServerRefreshRateMs();
-			break;
-		case Mode::CLIENT:
-			handleClientMode(elapsedTime);
-			sleepDurationMs = _client->getRefreshRateMs();
-			break;
-		case Mode::PEER:
-			handlePeerToPeerMode(elapsedTime);
-			sleepDurationMs = _peer->getRefreshRateMs();
-			break;
-		case Mode::SINGLE_PLAYER:
-			handleSinglePlayerMode(elapsedTime);
-			sleepDurationMs = 1000 / static_cast<int>(RefreshRate::SIXTY_FPS);
-			break;
-		}
+		int sleepDurationMs = step();
 		
 		int64_t sleepDurationNs = sleepDurationMs * 1e6;
 
@@ -289,62 +265,186 @@ void GameEngine::run() {
 	}
 }
 
+// Runs one iteration of the game loop. Used directly by hosts that schedule many engines
+// on a shared set of threads instead of giving each engine its own loop.
+int GameEngine::step() {
+	PROFILE_ZONE("GameEngine::step");
+	int64_t stepStart = _metrics ? Profiler::now() : 0;
+	int64_t currentTime = _timeline->getTime();
+	if (_previousTime < 0) _previousTime = currentTime;
+
+	int64_t elapsedTime = currentTime - _previousTime;
+	_previousTime = currentTime;
+	int sleepDurationMs = 0;
+	_frameArena.reset();
+	if (!updatesOnOwnThread()) prepareSimulation();
+
+	switch (_mode) {
+	case Mode::SERVER:
+		handleServerMode(elapsedTime);
+		sleepDurationMs = getServerRefreshRateMs();
+		break;
+	case Mode::CLIENT:
+		handleClientMode(elapsedTime);
+		sleepDurationMs = _client->getRefreshRateMs();
+		break;
+	case Mode::PEER:
+		handlePeerToPeerMode(elapsedTime);
+		sleepDurationMs = _peer->getRefreshRateMs();
+		break;
+	case Mode::SINGLE_PLAYER:
+		handleSinglePlayerMode(elapsedTime);
+		sleepDurationMs = 1000 / static_cast<int>(RefreshRate::SIXTY_FPS);
+		break;
+	}
+
+	if (_metrics) _metrics->recordTick(Profiler::now() - stepStart, _entities.size(), _physicsSystem->getAsleepCount());
+	return sleepDurationMs;
+}
+
+void GameEngine::prepareSimulation() {
+	// Entities resting on a static entity that moved have to fall or get pushed again
+	if (_staticWorldChanged.exchange(false)) {
+		_zoneIndex.rebuild(_entities);
+		_physicsSystem->wakeAll();
+	}
+	// Collision detection brings the static index up to date before physics sweeps fast entities against it
+	_physicsSystem->setStaticIndex(_runCollisionSystem ? &_staticIndex : nullptr);
+}
+
 // Handles the server's game engine logic in server-client multiplayer
 void GameEngine::handleServerMode(int64_t elapsedTime) {
+	PROFILE_ZONE("GameEngine::handleServerMode");
 
 	_eventManager->process();
 	_onCycle();
 	handleDeathZones();                                                                                // Handling death zone collisions
-	std::set<Entity*> entitiesWithCollisions = _runCollisionSystem ? _collisionSystem->run(_entities, _eventManager): std::set<Entity*>{};
+	float deltaTime = static_cast<float>(elapsedTime) * 1e-8f;
+
+	if (!_threadPool) {
+		detectCollisions(false);
+		_physicsSystem->run(deltaTime);
+		return;
+	}
+
+	// Partitioned simulation: collisions are detected per region and raised in the serial order,
+	// then physics is integrated in chunks on the same threads
+	detectCollisions(true);
+	_physicsSystem->run(deltaTime, _threadPool);
+}
+
+// Flags the entities that collided for physics (see Entity::isColliding). With collision handling disabled,
+// flags left from earlier ticks are cleared once.
+void GameEngine::detectCollisions(bool partitioned) {
+	if (_runCollisionSystem) {
+		if (partitioned) _spatialPartition->run(_entities, _staticIndex, _eventManager);
+		else _collisionSystem->run(_entities, _staticIndex, _eventManager, _threadPool);
+		_collisionFlagsSet = true;
+	}
+	else if (_collisionFlagsSet) {
+		for (Entity* entity : _entities) entity->setColliding(false);
+		_collisionFlagsSet = false;
+	}
+}
+
+// Creates the worker threads used by the simulation. Death zones and events stay on the calling thread.
+void GameEngine::setSimulationThreads(int threadCount) {
+	delete _spatialPartition;
+	delete _threadPool;
+	_spatialPartition = nullptr;
+	_threadPool = nullptr;
+
+	if (threadCount <= 0) return;
+
+	_threadPool = new ThreadPool(threadCount);
+	_spatialPartition = new SpatialPartition(_threadPool);
+}
+
+void GameEngine::setMetrics(ServerMetrics* metrics) {
+	_metrics = metrics;
+}
 
-	float deltaTime = static_cast<float>(elapsedTime) * 1e-8f;	
- 	_physicsSystem->run(deltaTime, entitiesWithCollisions);	
+int GameEngine::getSimulationThreads() const {
+	return _threadPool ? _threadPool->getThreadCount() : 0;
 }
 
-// Handles the client's game engine logic in server-client multiplayer
+// Handles the client's game engine logic in server-client multiplayer. Events, networking and the cycle callback
+// run on the update thread; this thread only draws the latest world state it published.
 void GameEngine::handleClientMode(int64_t elapsedTime) {
+	PROFILE_ZONE("GameEngine::handleClientMode");
 	SDL_PumpEvents(); // Force an event queue update
-	_renderer->clear();
 
-	_entities = _client->getEntities();
+	auto [scaleX, scaleY] = _window->getScaleFactors();
+	_windowScaleX = scaleX;
+	_windowScaleY = scaleY;
 
-	std::thread heartbeatThread([this]() {
-		_client->sendHeartbeatToServer();
-		});
+	startUpdateThread();
+	renderLatestState();
+}
 
-	std::thread eventThread([this]() {
+int GameEngine::updateClient() {
+	PROFILE_ZONE("GameEngine::updateClient");
+	{
+		PROFILE_ZONE("Client events and networking");
 		_eventManager->process();
-		_inputManager->process(_eventManager);		
+		_inputManager->process(_eventManager);
+		_client->setApplyUpdates(!_replaySystem->isReplaying());     // Live updates are dropped while a replay runs
+		_client->setUpdateEventsEnabled(_replaySystem->isRecording());
 		_client->receiveEntityUpdatesFromServer(_eventManager);
 		_client->receiveMessagesFromServer();
-		});
+		_client->sendHeartbeatToServer();                     // No-op unless the connection has been idle
+	}
 
-	std::thread callbackThread([this]() {
-		_onCycle();
-		});
+	_onCycle();
 
-	auto [scaleX, scaleY] = _window->getScaleFactors();
+	float scaleX = _windowScaleX;
+	float scaleY = _windowScaleY;
 	resizeCamera(scaleX, scaleY);
+	scaleEntities(scaleX, scaleY);
 
-	// Rendering all entities
-	for (Entity* entity : _entities) {
-		entity->applyScaling(scaleX, scaleY);		
+	// Only entities within the viewport and no ghost entities are rendered
+	_renderStates.beginWrite().capture(_client->getEntities(), _camera, true);
+	_renderStates.publish();
+	return _client->getRefreshRateMs();
+}
+
+void GameEngine::renderLatestState() {
+	PROFILE_ZONE("GameEngine::render");
+	_renderer->clear();
+	if (const RenderState* state = _renderStates.acquire()) _renderer->render(*state);
+	_renderer->present();
+}
+
+void GameEngine::startUpdateThread() {
+	if (_updating) return;
 
-		// Only render if within the viewport and not ghost entities
-		if (entity->isWithinViewPort(_camera) && entity->getEntityType() != EntityType::GHOST) {
-			entity->render(_renderer->getSDLRenderer(), _camera);  
+	_updating = true;
+	_updateThread = std::thread([this]() {
+		PROFILE_THREAD("Engine update");
+		while (_updating) {
+			auto start = std::chrono::steady_clock::now();
+			int sleepDurationMs = _mode == Mode::CLIENT ? updateClient() : updateSinglePlayer();
+			std::this_thread::sleep_until(start + std::chrono::milliseconds(sleepDurationMs));
 		}
-	}
+		});
+}
 
-	_renderer->present();
+// Waits for the running update to finish
+void GameEngine::stopUpdateThread() {
+	_updating = false;
+	if (_updateThread.joinable()) _updateThread.join();
+}
 
-	eventThread.join();
-	callbackThread.join();	
-	heartbeatThread.join();	
+bool GameEngine::updatesOnOwnThread() const {
+	return _mode == Mode::CLIENT || (_mode == Mode::SINGLE_PLAYER && _pipelined);
 }
 
+void GameEngine::setPipelined(bool pipelined) { _pipelined = pipelined; }
+bool GameEngine::isPipelined() const { return _pipelined; }
+
 // Handles the logic for peers in peer to peer mode
 void GameEngine::handlePeerToPeerMode(int64_t elapsedTime) {
+	PROFILE_ZONE("GameEngine::handlePeerToPeerMode");
 	SDL_PumpEvents();
 	_renderer->clear();
 	float deltaTime = static_cast<float>(elapsedTime) * 1e-8f;
@@ -361,14 +461,14 @@ void GameEngine::handlePeerToPeerMode(int64_t elapsedTime) {
 		_peer->receiveUpdates();
 		});
 
-	std::set<Entity*> entitiesWithCollisions = _runCollisionSystem ? _collisionSystem->run(_entities, _eventManager): std::set<Entity*>{};
-	_physicsSystem->runForGivenEntities(deltaTime, entitiesWithCollisions, _peer->getEntitiesToProcess());
+	detectCollisions(false);
+	_physicsSystem->runForGivenEntities(deltaTime, _peer->getEntitiesToProcess(_frameArena));
 
 	auto [scaleX, scaleY] = _window->getScaleFactors();
+	scaleEntities(scaleX, scaleY);
 
 	// Rendering all entities
 	for (Entity* entity : _entities) {
-		entity->applyScaling(scaleX, scaleY);		
 		entity->render(_renderer->getSDLRenderer(), _camera);
 	}
 
@@ -383,7 +483,19 @@ void GameEngine::handlePeerToPeerMode(int64_t elapsedTime) {
 	
 // Handles the singleplayer game engine logic.
 void GameEngine::handleSinglePlayerMode(int64_t elapsedTime) {
+	PROFILE_ZONE("GameEngine::handleSinglePlayerMode");
 	SDL_PumpEvents(); // Force an event queue update
+
+	if (_pipelined) {
+		auto [scaleX, scaleY] = _window->getScaleFactors();
+		_windowScaleX = scaleX;
+		_windowScaleY = scaleY;
+
+		startUpdateThread();
+		renderLatestState();
+		return;
+	}
+
 	_renderer->clear();
 
 	float deltaTime = static_cast<float>(elapsedTime) * 1e-8f;
@@ -397,23 +509,26 @@ void GameEngine::handleSinglePlayerMode(int64_t elapsedTime) {
 	});
 
 	std::thread physicsThread([this, deltaTime]() {
-		std::set<Entity*> entitiesWithCollisions = _runCollisionSystem ? _collisionSystem->run(_entities, _eventManager): std::set<Entity*>{};
-		_physicsSystem->run(deltaTime, entitiesWithCollisions);
+		detectCollisions(false);
+		_physicsSystem->run(deltaTime);
 	});
 
 	std::thread eventThread([this]() {
 		_eventManager->process();
 		});
 
-	auto [scaleX, scaleY] = _window->getScaleFactors();
+	{
+		PROFILE_ZONE("GameEngine::render");
+		auto [scaleX, scaleY] = _window->getScaleFactors();
+		scaleEntities(scaleX, scaleY);
 
-	// Rendering all entities
-	for (Entity* entity : _entities) {
-		entity->applyScaling(scaleX, scaleY);		
-		entity->render(_renderer->getSDLRenderer(), _camera);              // Rendering all entities
-	}
+		// Rendering all entities
+		for (Entity* entity : _entities) {
+			entity->render(_renderer->getSDLRenderer(), _camera);              // Rendering all entities
+		}
 
-	_renderer->present();
+		_renderer->present();
+	}
 
 	inputThread.join();
 	callbackThread.join();
@@ -421,6 +536,28 @@ void GameEngine::handleSinglePlayerMode(int64_t elapsedTime) {
 	eventThread.join();
 }
 
+// Pipelined single player: the frame simulated here is rendered from its copy while the next one is simulated
+int GameEngine::updateSinglePlayer() {
+	PROFILE_ZONE("GameEngine::updateSinglePlayer");
+	int64_t currentTime = _timeline->getTime();
+	if (_updatePreviousTime < 0) _updatePreviousTime = currentTime;
+	float deltaTime = static_cast<float>(currentTime - _updatePreviousTime) * 1e-8f;
+	_updatePreviousTime = currentTime;
+
+	_inputManager->process(_eventManager);
+	_eventManager->process();
+	_onCycle();
+
+	prepareSimulation();
+	detectCollisions(false);
+	_physicsSystem->run(deltaTime);
+
+	scaleEntities(_windowScaleX, _windowScaleY);
+	_renderStates.beginWrite().capture(_entities, _camera, false);
+	_renderStates.publish();
+	return 1000 / static_cast<int>(RefreshRate::SIXTY_FPS);
+}
+
 // Sends the user input to server 
 void GameEngine::sendInputToServer(const std::string& buttonPress) {
 	_client->sendInputToServer(buttonPress);
@@ -429,10 +566,11 @@ void GameEngine::sendInputToServer(const std::string& buttonPress) {
 
 // Quits the game engine. Destroys all objects
 void GameEngine::shutdown() {
+	stopUpdateThread();
 	_renderer->shutdown();
 	_window->shutdown();
 
-	for (Entity* entity : _entities) {
+	for (Entity* entity : getEntities()) {
 		entity->shutdown();
 	}
 
@@ -451,12 +589,14 @@ EventManager* GameEngine::getEventManager() { return _eventManager; }
 GameState GameEngine::getGameState() { return _gameState; }
 PhysicsSystem* GameEngine::getPhysicsSystem() { return _physicsSystem; }
 CollisionSystem* GameEngine::getCollisionSystem() { return _collisionSystem; }
+ZoneIndex& GameEngine::getZoneIndex() { return _zoneIndex; }
 Window* GameEngine::getWindow() { return _window; }
 Client* GameEngine::getClient() { return _client; }
 Peer* GameEngine::getPeer() { return _peer; }
 int GameEngine::getServerRefreshRateMs() const { return _serverRefreshRateMs; }
-std::vector<Entity*>& GameEngine::getEntities() { return _entities; }
+std::vector<Entity*>& GameEngine::getEntities() { return _client ? _client->getEntities() : _entities; }
 Camera& GameEngine::getCamera() { return _camera; }
+FrameArena& GameEngine::getFrameArena() { return _frameArena; }
 ReplaySystem* GameEngine::getReplaySystem() const { return _replaySystem; }
 
 
@@ -464,6 +604,7 @@ ReplaySystem* GameEngine::getReplaySystem() const { return _replaySystem; }
 void GameEngine::setGameState(GameState state) { _gameState = state; }
 void GameEngine::setServerRefreshRateMs(int rate) { _serverRefreshRateMs = rate; }
 void GameEngine::setClientMap(std::map<int, Entity*>& clientMap) { _clientMap = &clientMap; }
+void GameEngine::setPhysicsSystem(PhysicsSystem* physicsSystem) { _physicsSystem = physicsSystem; }
 
 // Runs on each game cycle
 void GameEngine::setOnCycle(const std::function<void()> &cb) {
@@ -501,6 +642,35 @@ void GameEngine::setEntities(const std::vector<std::shared_ptr<Entity>> &entitie
 	for (const auto &entity : entities) {
 		_entities.push_back(entity.get());
 	}
+	assignWorldSlots();
+	classifyEntities();
+}
+
+void GameEngine::addEntity(Entity* entity) {
+	entity->setWorldSlot(static_cast<int>(_entities.size()));
+	_entities.push_back(entity);
+}
+
+void GameEngine::removeEntity(Entity* entity) {
+	_physicsSystem->removeEntity(*entity);
+
+	int slot = entity->getWorldSlot();
+	if (slot < 0 || slot >= static_cast<int>(_entities.size()) || _entities[slot] != entity) {
+		// The list was filled or replaced through getEntities since the slots were assigned
+		entity->setWorldSlot(-1);
+		assignWorldSlots();
+		slot = entity->getWorldSlot();
+		if (slot < 0) return;
+	}
+
+	_entities[slot] = _entities.back();
+	_entities[slot]->setWorldSlot(slot);
+	_entities.pop_back();
+	entity->setWorldSlot(-1);
+}
+
+void GameEngine::assignWorldSlots() {
+	for (size_t i = 0; i < _entities.size(); i++) _entities[i]->setWorldSlot(static_cast<int>(i));
 }
 
 void GameEngine::enableCollisionHandling() {
@@ -4,6 +4,12 @@
 #include <EventManager.h>
 #include "Peer.h"
 #include "CollisionSystem.h"
+#include "SpatialPartition.h"
+#include "ZoneIndex.h"
+#include "StaticIndex.h"
+#include "ThreadPool.h"
+#include "FrameArena.h"
+#include "RenderState.h"
 #include "Window.h"
 #include "Renderer.h"
 #include "PhysicsSystem.h"
@@ -11,6 +17,9 @@
 #include "Client.h"
 #include "../TimeSystem/Timeline.h"
 #include "ReplaySystem.h"
+#include "ServerMetrics.h"
+#include <atomic>
+#include <thread>
 
 
 // Class, functions, variables signatures of the Game Engine class. This class delegates work to 
@@ -22,6 +31,8 @@ public:
 
 	bool initialize(std::vector<Entity*>& entities);
 	void run();
+	// Runs a single iteration of the game loop and returns how long to wait (ms) before the next one
+	int step();
 	void shutdown();
 
 	InputManager * getInputManager();
@@ -36,7 +47,32 @@ public:
 	// A callback function that is triggered after each render cycle
 	void setOnCycle(const std::function<void()> &);
 	PhysicsSystem* getPhysicsSystem();
+	// Replaces the shared physics system, for worlds simulated side by side in one process. Call before initialize.
+	void setPhysicsSystem(PhysicsSystem* physicsSystem);
 	CollisionSystem* getCollisionSystem();
+	// Zones of the world passed to initialize. Rebuild it when zones are added or moved afterwards.
+	ZoneIndex& getZoneIndex();
+	// Marks FIXED entities and zones that physics does not simulate as static (see Entity::isStatic). Called by
+	// initialize and setEntities; call it again after replacing the entity list some other way.
+	void classifyEntities();
+	// Call after moving, resizing or retyping a static entity. The collision grid and the zone index are rebuilt
+	// on the next step, and static entities are rescaled on the next render. Safe to call from any thread.
+	void invalidateStaticWorld();
+	// Runs collision detection and physics of the server simulation on the given number of threads using
+	// a spatial partition. In peer and single player mode the threads test the collision pairs. 0 restores
+	// the serial collision check.
+	void setSimulationThreads(int threadCount);
+	int getSimulationThreads() const;
+	// Records the duration of every step and the number of simulated entities
+	void setMetrics(ServerMetrics* metrics);
+	// Single player only. Simulates the next frame on an update thread while the main thread renders a copy of
+	// the previous one (see RenderState). Input, events, the cycle callback, collisions and physics then run on
+	// the update thread, so change the world from the callback only. Call before run.
+	void setPipelined(bool pipelined);
+	bool isPipelined() const;
+	// Scratch memory for the current step, dropped when the next step begins. Only use it on the thread
+	// running step().
+	FrameArena& getFrameArena();
 	Window* getWindow();
 
 	void toggleScalingMode();
@@ -50,8 +86,13 @@ public:
 	int getServerRefreshRateMs() const;
 	void setServerRefreshRateMs(int rate);
 
+	// In client mode the client's entities, which the update thread changes; only use them in the cycle callback
 	std::vector<Entity*>& getEntities();
 	void setEntities(const std::vector<std::shared_ptr<Entity>> &entities);
+	// Adds an entity to the world in constant time. It is only simulated if it is registered with physics.
+	void addEntity(Entity* entity);
+	// Removes an entity from the world and from physics in constant time. The last entity takes its place.
+	void removeEntity(Entity* entity);
 
 	void initializeCamera(int width, int height);
 	void resizeCamera(float scaleX, float scaleY);
@@ -76,10 +117,34 @@ private:
 	EventManager* _eventManager;
 	ReplaySystem* _replaySystem;
 	bool _runCollisionSystem = true;
+	bool _collisionFlagsSet = false;                             // Entities may still be flagged as colliding
+	ThreadPool* _threadPool = nullptr;                           // Only created for partitioned simulation
+	SpatialPartition* _spatialPartition = nullptr;
+	ZoneIndex _zoneIndex;
+	StaticIndex _staticIndex;                                    // Static entities, kept out of the per-tick collision pairs
+	std::atomic<bool> _staticWorldChanged{ false };
+	std::atomic<uint64_t> _staticRevision{ 0 };                  // Bumped by invalidateStaticWorld
+	uint64_t _scaledRevision = UINT64_MAX;                       // Static world and window scale static entities were last scaled for
+	float _scaledX = 0.0f;
+	float _scaledY = 0.0f;
+	std::vector<Entity*> _nearbyZones;                           // Reused by handleDeathZones
+	FrameArena _frameArena;
+	ServerMetrics* _metrics = nullptr;
+	int64_t _previousTime = -1;                                  // Timeline time of the previous loop iteration
 
 	Client* _client = nullptr;
 	Peer* _peer = nullptr;
 	std::map<int, Entity*>* _clientMap;
+
+	// Client mode and pipelined single player update the world on their own thread and hand each frame to the
+	// render thread as a copy
+	bool _pipelined = false;
+	std::thread _updateThread;
+	std::atomic<bool> _updating{ false };
+	RenderStateBuffer _renderStates;
+	std::atomic<float> _windowScaleX{ 1.0f };                    // Read from the window on the render thread
+	std::atomic<float> _windowScaleY{ 1.0f };
+	int64_t _updatePreviousTime = -1;                            // Timeline time of the previous update
 	
 	void handleServerMode(int64_t elapsedTime);
 	void handleClientMode(int64_t elapsedTime);
@@ -88,6 +153,24 @@ private:
 
 	void setUpEventHandlers();
 	void handleDeathZones();
+	// Runs the collision system, or the spatial partition if 'partitioned'
+	void detectCollisions(bool partitioned);
+	// Tells every entity its slot in the entity list (see Entity::getWorldSlot)
+	void assignWorldSlots();
+	void scaleEntities(float scaleX, float scaleY);
+	// True when the world is updated on the update thread instead of in step()
+	bool updatesOnOwnThread() const;
+	void startUpdateThread();
+	void stopUpdateThread();
+	// Rebuilds what a change of the static world invalidated, before collisions and physics run
+	void prepareSimulation();
+	// Receives the server's updates, runs the cycle callback and publishes the next render state. Returns how
+	// long to wait (ms) before the next update.
+	int updateClient();
+	// Simulates one single player frame and publishes its render state. Returns how long to wait (ms).
+	int updateSinglePlayer();
+	// Draws the newest published render state
+	void renderLatestState();
 
 	int _serverRefreshRateMs;
 
@@ -0,0 +1,57 @@
+#include "MemoryPool.h"
+#include <algorithm>
+#include <new>
+
+MemoryPool::MemoryPool(size_t blockSize, size_t blocksPerChunk) {
+	// Every block keeps the alignment of the chunk it is carved from
+	const size_t alignment = alignof(std::max_align_t);
+	blockSize = std::max(blockSize, sizeof(FreeBlock));
+	_blockSize = (blockSize + alignment - 1) / alignment * alignment;
+	_blocksPerChunk = std::max<size_t>(1, blocksPerChunk);
+}
+
+MemoryPool::~MemoryPool() {
+	for (void* chunk : _chunks) ::operator delete(chunk);
+}
+
+void* MemoryPool::allocate() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_freeList) {
+		char* chunk = static_cast<char*>(::operator new(_blockSize * _blocksPerChunk));
+		_chunks.push_back(chunk);
+		_capacity += _blocksPerChunk;
+
+		// Threaded in reverse so blocks are handed out in address order
+		for (size_t i = _blocksPerChunk; i-- > 0;) {
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * _blockSize);
+			block->next = _freeList;
+			_freeList = block;
+		}
+	}
+
+	FreeBlock* block = _freeList;
+	_freeList = block->next;
+	_usedCount++;
+	return block;
+}
+
+void MemoryPool::deallocate(void* block) {
+	if (!block) return;
+	std::lock_guard<std::mutex> lock(_mutex);
+	FreeBlock* freed = static_cast<FreeBlock*>(block);
+	freed->next = _freeList;
+	_freeList = freed;
+	_usedCount--;
+}
+
+size_t MemoryPool::getBlockSize() const { return _blockSize; }
+
+size_t MemoryPool::getCapacity() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _capacity;
+}
+
+size_t MemoryPool::getUsedCount() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _usedCount;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Hands out blocks of one fixed size, carved from chunks that are allocated as the pool grows and only freed
+// with the pool. Freed blocks are reused, so once the pool has grown to the peak number of live blocks,
+// allocating and freeing never reach the heap. Safe to call from any thread.
+class MemoryPool {
+public:
+	explicit MemoryPool(size_t blockSize, size_t blocksPerChunk = 256);
+	~MemoryPool();
+
+	MemoryPool(const MemoryPool&) = delete;
+	void operator=(const MemoryPool&) = delete;
+
+	// Returns a block of at least getBlockSize() bytes, aligned for any type
+	void* allocate();
+	void deallocate(void* block);
+
+	size_t getBlockSize() const;
+	// Blocks carved so far, and how many of them are handed out
+	size_t getCapacity() const;
+	size_t getUsedCount() const;
+
+private:
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	size_t _blockSize;
+	size_t _blocksPerChunk;
+	mutable std::mutex _mutex;
+	FreeBlock* _freeList = nullptr;
+	std::vector<void*> _chunks;
+	size_t _capacity = 0;
+	size_t _usedCount = 0;
+};
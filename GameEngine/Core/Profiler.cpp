@@ -0,0 +1,216 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+int64_t Profiler::now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()
+	).count();
+}
+
+// Returns the calling thread's buffer. The engine starts short-lived threads every frame, so the
+// buffer of a finished thread is handed to the next new thread instead of allocating another ring.
+// The zones of every thread keep their own thread ID and name.
+Profiler::ThreadBuffer& Profiler::threadBuffer() {
+	struct Holder {
+		ThreadBuffer* buffer = nullptr;
+		~Holder() {
+			if (buffer) Profiler::getInstance().releaseBuffer(buffer);
+		}
+	};
+	thread_local Holder holder;
+	if (holder.buffer) return *holder.buffer;
+
+	std::lock_guard<std::mutex> lock(_buffersMutex);
+	for (auto& buffer : _buffers) {
+		if (!buffer->inUse) {
+			holder.buffer = buffer.get();
+			break;
+		}
+	}
+
+	if (!holder.buffer) {
+		_buffers.emplace_back(new ThreadBuffer());
+		holder.buffer = _buffers.back().get();
+		holder.buffer->ring.resize(RING_SIZE);
+	}
+
+	ThreadBuffer& buffer = *holder.buffer;
+	std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+	buffer.inUse = true;
+	buffer.depth = 0;
+
+	// Forget the threads whose zones were all overwritten
+	uint64_t written = buffer.written.load(std::memory_order_relaxed);
+	uint64_t oldest = written > RING_SIZE ? written - RING_SIZE : 0;
+	while (buffer.threads.size() > 1 && buffer.threads[1].start <= oldest) buffer.threads.erase(buffer.threads.begin());
+
+	uint32_t threadId = ++_nextThreadId;
+	buffer.threads.push_back({ written, threadId, "Thread " + std::to_string(threadId) });
+	return buffer;
+}
+
+void Profiler::releaseBuffer(ThreadBuffer* buffer) {
+	std::lock_guard<std::mutex> lock(_buffersMutex);
+	buffer->inUse = false;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+	ThreadBuffer& buffer = threadBuffer();
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	buffer.threads.back().name = name;
+}
+
+uint32_t Profiler::beginZone() {
+	return threadBuffer().depth++;
+}
+
+void Profiler::endZone(const char* name, int64_t start, uint32_t depth) {
+	int64_t end = now();
+	ThreadBuffer& buffer = threadBuffer();
+	buffer.depth = depth;
+
+	uint64_t index = buffer.written.load(std::memory_order_relaxed);
+	buffer.ring[index % RING_SIZE] = { name, start, end, depth };
+	buffer.written.store(index + 1, std::memory_order_release);
+}
+
+uint64_t Profiler::copyRing(ThreadBuffer& buffer, std::vector<ZoneRecord>& records) {
+	uint64_t end = buffer.written.load(std::memory_order_acquire);
+	uint64_t begin = std::max(buffer.cleared.load(), end > RING_SIZE ? end - RING_SIZE : 0);
+
+	records.clear();
+	records.reserve(static_cast<size_t>(end - begin));
+	for (uint64_t i = begin; i < end; i++) {
+		records.push_back(buffer.ring[i % RING_SIZE]);
+	}
+
+	// The owner kept writing while the ring was copied; zones whose slots it reached may be torn
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t after = buffer.written.load(std::memory_order_relaxed);
+	uint64_t valid = after >= RING_SIZE ? after - RING_SIZE + 1 : 0;
+	if (valid > begin) {
+		size_t dropped = static_cast<size_t>(std::min<uint64_t>(valid - begin, records.size()));
+		records.erase(records.begin(), records.begin() + dropped);
+		begin += dropped;
+	}
+	return begin;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+	std::ofstream out(path);
+	if (!out) return false;
+
+	std::lock_guard<std::mutex> lock(_buffersMutex);
+	int64_t origin = INT64_MAX;
+	std::vector<std::vector<ZoneRecord>> rings(_buffers.size());
+	std::vector<uint64_t> firstIndices(_buffers.size());
+	std::vector<std::vector<ThreadSegment>> threads(_buffers.size());
+	for (size_t i = 0; i < _buffers.size(); i++) {
+		{
+			std::lock_guard<std::mutex> bufferLock(_buffers[i]->mutex);
+			threads[i] = _buffers[i]->threads;
+		}
+		firstIndices[i] = copyRing(*_buffers[i], rings[i]);
+		if (!rings[i].empty()) origin = std::min(origin, rings[i].front().start);
+	}
+
+	// Complete events ("X") with microsecond timestamps, plus one thread name record per thread
+	out << "{\"traceEvents\":[\n";
+	bool first = true;
+	char line[256];
+	for (size_t i = 0; i < _buffers.size(); i++) {
+		for (size_t t = 0; t < threads[i].size(); t++) {
+			const ThreadSegment& thread = threads[i][t];
+			uint64_t begin = std::max(thread.start, firstIndices[i]);
+			uint64_t end = firstIndices[i] + rings[i].size();
+			if (t + 1 < threads[i].size()) end = std::min(end, threads[i][t + 1].start);
+			if (begin >= end && t + 1 < threads[i].size()) continue;
+
+			snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",\n", thread.threadId, thread.name.c_str());
+			out << line;
+			first = false;
+
+			for (uint64_t index = begin; index < end; index++) {
+				const ZoneRecord& record = rings[i][static_cast<size_t>(index - firstIndices[i])];
+				snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					record.name, thread.threadId, (record.start - origin) / 1e3, (record.end - record.start) / 1e3);
+				out << line;
+			}
+		}
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return static_cast<bool>(out);
+}
+
+std::string Profiler::summary() {
+	std::map<std::string, std::vector<int64_t>> durations;
+	{
+		std::lock_guard<std::mutex> lock(_buffersMutex);
+		std::vector<ZoneRecord> records;
+		for (auto& buffer : _buffers) {
+			copyRing(*buffer, records);
+			for (const ZoneRecord& record : records) {
+				durations[record.name].push_back(record.end - record.start);
+			}
+		}
+	}
+
+	std::ostringstream oss;
+	char line[256];
+	snprintf(line, sizeof(line), "%-40s %8s %10s %10s %10s %10s\n", "zone", "count", "min (us)", "avg (us)", "p99 (us)", "max (us)");
+	oss << line;
+
+	for (auto& [name, samples] : durations) {
+		std::sort(samples.begin(), samples.end());
+		double total = 0;
+		for (int64_t sample : samples) total += static_cast<double>(sample);
+
+		size_t p99 = std::min(samples.size() - 1, static_cast<size_t>(samples.size() * 0.99));
+		snprintf(line, sizeof(line), "%-40s %8zu %10.1f %10.1f %10.1f %10.1f\n", name.c_str(), samples.size(),
+			samples.front() / 1e3, total / samples.size() / 1e3, samples[p99] / 1e3, samples.back() / 1e3);
+		oss << line;
+	}
+	return oss.str();
+}
+
+void Profiler::clear() {
+	std::lock_guard<std::mutex> lock(_buffersMutex);
+	for (auto& buffer : _buffers) {
+		buffer->cleared = buffer->written.load();
+	}
+}
+
+// Reads commands from stdin on a background thread: "trace [file]" writes a Chrome trace, "stats" prints the summary
+void Profiler::startConsole() {
+	std::thread([this]() {
+		std::string line;
+		while (std::getline(std::cin, line)) {
+			std::istringstream iss(line);
+			std::string command, path;
+			iss >> command >> path;
+
+			if (command == "trace") {
+				if (path.empty()) path = "trace.json";
+				printf(writeChromeTrace(path) ? "Profiler: trace written to %s\n" : "Profiler: could not write %s\n", path.c_str());
+			}
+			else if (command == "stats") {
+				printf("%s", summary().c_str());
+			}
+			else if (command == "clear") {
+				clear();
+			}
+		}
+	}).detach();
+}
+
+void Profiler::setEnabled(bool enabled) { _enabled = enabled; }
+bool Profiler::isEnabled() const { return _enabled; }
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Frame profiler. Scoped zones are recorded into a ring buffer per thread; the rings hold the most
+// recent zones and act as the rolling window for the summary. Zone names must be string literals.
+//
+// The macros compile to nothing unless GAME_ENGINE_PROFILE is defined (cmake -DGAME_ENGINE_PROFILE=ON):
+//   PROFILE_ZONE("name")         times the enclosing scope
+//   PROFILE_THREAD("name")       names the calling thread in traces
+//   PROFILE_CONSOLE()            starts a thread that reads "trace [file]" / "stats" commands from stdin
+class Profiler {
+public:
+	struct ZoneRecord {
+		const char* name;
+		int64_t start;                                                   // ns, steady clock
+		int64_t end;
+		uint32_t depth;                                                  // Nesting level on its thread
+	};
+
+	static Profiler& getInstance() {
+		static Profiler instance;                                        // Singleton variable
+		return instance;
+	}
+
+	Profiler(const Profiler&) = delete;                                  // Preventing copying
+	void operator=(const Profiler&) = delete;                            // Preventing assignment
+
+	void setThreadName(const std::string& name);
+
+	// Writes the recorded zones of all threads as Chrome trace-event JSON (chrome://tracing, Perfetto)
+	bool writeChromeTrace(const std::string& path);
+	// Per-zone count, min, avg, p99 and max over the zones currently held in the rings
+	std::string summary();
+	void clear();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const;
+	void startConsole();
+
+	static int64_t now();
+
+	// Used by ProfileZone
+	uint32_t beginZone();
+	void endZone(const char* name, int64_t start, uint32_t depth);
+
+private:
+	Profiler() = default;
+
+	// A thread that used a buffer, and the zones it wrote from 'start' on
+	struct ThreadSegment {
+		uint64_t start;
+		uint32_t threadId;
+		std::string name;
+	};
+
+	// Only the owning thread writes zones, without locking; readers copy the ring and drop the zones that
+	// were overwritten meanwhile
+	struct ThreadBuffer {
+		std::mutex mutex;                                                // Guards 'threads', never taken to record a zone
+		std::vector<ThreadSegment> threads;                              // Oldest first
+		std::vector<ZoneRecord> ring;
+		std::atomic<uint64_t> written{ 0 };                              // Total zones written; the ring holds the last ones
+		std::atomic<uint64_t> cleared{ 0 };                              // Zones before this one were dropped by clear()
+		uint32_t depth = 0;
+		bool inUse = false;
+	};
+
+	static constexpr size_t RING_SIZE = 1 << 16;
+
+	ThreadBuffer& threadBuffer();
+	void releaseBuffer(ThreadBuffer* buffer);
+	// Copies the zones held in the ring, oldest first, and returns the index of the first one
+	uint64_t copyRing(ThreadBuffer& buffer, std::vector<ZoneRecord>& records);
+
+	std::mutex _buffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> _buffers;                 // Reused by new threads once their thread exits
+	uint32_t _nextThreadId = 0;
+	std::atomic<bool> _enabled{ true };
+};
+
+// Records the time between its construction and destruction as a zone
+class ProfileZone {
+public:
+	explicit ProfileZone(const char* name) : _name(name) {
+		Profiler& profiler = Profiler::getInstance();
+		if (!profiler.isEnabled()) {
+			_name = nullptr;
+			return;
+		}
+		_depth = profiler.beginZone();
+		_start = Profiler::now();
+	}
+
+	~ProfileZone() {
+		if (_name) Profiler::getInstance().endZone(_name, _start, _depth);
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	void operator=(const ProfileZone&) = delete;
+
+private:
+	const char* _name;
+	int64_t _start = 0;
+	uint32_t _depth = 0;
+};
+
+#ifdef GAME_ENGINE_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_THREAD(name) Profiler::getInstance().setThreadName(name)
+#define PROFILE_CONSOLE() Profiler::getInstance().startConsole()
+#else
+#define PROFILE_ZONE(name) ((void)0)
+#define PROFILE_THREAD(name) ((void)0)
+#define PROFILE_CONSOLE() ((void)0)
+#endif
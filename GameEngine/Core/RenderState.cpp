@@ -0,0 +1,54 @@
+#include "RenderState.h"
+#include "Profiler.h"
+
+void RenderState::capture(const std::vector<Entity*>& entities, const Camera& camera, bool cullHidden) {
+	PROFILE_ZONE("RenderState::capture");
+	_camera = camera;
+	_items.clear();
+	_texturePathCount = 0;
+
+	for (const Entity* entity : entities) {
+		if (cullHidden && (entity->getEntityType() == EntityType::GHOST || !entity->isWithinViewPort(camera))) continue;
+
+		Item item;
+		item.shape = entity->getShapeType();
+		item.position = entity->getPosition();
+		item.size = entity->getSize();
+		item.circleRadius = entity->getCircleRadius();
+		item.triangleBaseLength = entity->getTriangleBaseLength();
+		item.triangleHeight = entity->getTriangleHeight();
+		item.rotationAngle = entity->getRotationAngle();
+		item.color = entity->getColor();
+		item.texturePath = -1;
+
+		const std::string& texturePath = entity->getTexturePath();
+		if (!texturePath.empty()) {
+			if (_texturePathCount == _texturePaths.size()) _texturePaths.emplace_back();
+			_texturePaths[_texturePathCount].assign(texturePath);
+			item.texturePath = static_cast<int>(_texturePathCount++);
+		}
+		_items.push_back(item);
+	}
+}
+
+const std::vector<RenderState::Item>& RenderState::getItems() const { return _items; }
+const std::string& RenderState::getTexturePath(int index) const { return _texturePaths[index]; }
+const Camera& RenderState::getCamera() const { return _camera; }
+
+RenderState& RenderStateBuffer::beginWrite() {
+	return _states[_writing];
+}
+
+void RenderStateBuffer::publish() {
+	uint8_t previous = _latest.exchange(static_cast<uint8_t>(_writing | FRESH), std::memory_order_acq_rel);
+	_writing = previous & INDEX_MASK;
+}
+
+const RenderState* RenderStateBuffer::acquire() {
+	if (_latest.load(std::memory_order_acquire) & FRESH) {
+		uint8_t latest = _latest.exchange(_reading, std::memory_order_acq_rel);
+		_reading = latest & INDEX_MASK;
+		_acquired = true;
+	}
+	return _acquired ? &_states[_reading] : nullptr;
+}
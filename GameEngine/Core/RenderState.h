@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Entity.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// What the renderer needs of the world at one moment: the camera and the geometry and look of the entities,
+// copied on the thread that updates them. The render thread draws the copy (see Renderer::render) without
+// touching any entity, so it never sees an entity half updated.
+class RenderState {
+public:
+	struct Item {
+		ShapeType shape;
+		Position position;                                           // Scaled to the window, as Entity::getPosition
+		Size size;
+		float circleRadius;
+		float triangleBaseLength;
+		float triangleHeight;
+		float rotationAngle;
+		SDL_Color color;
+		int texturePath;                                             // See getTexturePath, -1 if there is none
+	};
+
+	// Replaces the state with the entities and the camera. With 'cullHidden', ghost entities and entities
+	// outside the camera's view are left out.
+	void capture(const std::vector<Entity*>& entities, const Camera& camera, bool cullHidden);
+
+	const std::vector<Item>& getItems() const;
+	const std::string& getTexturePath(int index) const;
+	const Camera& getCamera() const;
+
+private:
+	std::vector<Item> _items;
+	std::vector<std::string> _texturePaths;                          // Kept between captures to reuse their buffers
+	size_t _texturePathCount = 0;
+	Camera _camera{};
+};
+
+// Hands render states from one producer thread to one render thread without locks. Of three states, the
+// producer fills one, the renderer draws another, and the third is the latest complete one; publishing and
+// acquiring each swap a state with the third. The renderer always draws the newest complete state, and
+// neither thread ever waits for the other.
+class RenderStateBuffer {
+public:
+	// The state to fill next. Only for the producer thread.
+	RenderState& beginWrite();
+	// Makes the state from beginWrite the latest one
+	void publish();
+	// The latest published state, or nullptr before the first one. It stays unchanged until the next call.
+	// Only for the render thread.
+	const RenderState* acquire();
+
+private:
+	static const uint8_t INDEX_MASK = 3;
+	static const uint8_t FRESH = 4;                                  // The latest state was not acquired yet
+
+	RenderState _states[3];
+	std::atomic<uint8_t> _latest{ 0 };
+	uint8_t _writing = 1;
+	uint8_t _reading = 2;
+	bool _acquired = false;                                          // The renderer holds a published state
+};
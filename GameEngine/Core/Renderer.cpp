@@ -1,4 +1,7 @@
 #include "Renderer.h"
+#include "RenderState.h"
+#include "TextureCache.h"
+#include "Profiler.h"
 #ifdef __APPLE__
 #include <SDL2/SDL.h>
 #else
@@ -40,6 +43,10 @@ void Renderer::present() {
 
 // Destroys the renderer object and sets it to null pointer.
 void Renderer::shutdown() {
+	if (_solidTexture) {
+		SDL_DestroyTexture(_solidTexture);
+		_solidTexture = nullptr;
+	}
 	if (_renderer) {
 		SDL_DestroyRenderer(_renderer);
 		_renderer = nullptr;
@@ -49,3 +56,76 @@ void Renderer::shutdown() {
 SDL_Renderer* Renderer::getSDLRenderer() {
 	return _renderer;
 }
+
+// Draws every item of the state the way Entity::render draws the entity it was captured from
+void Renderer::render(const RenderState& state) {
+	PROFILE_ZONE("Renderer::render");
+	const Camera& camera = state.getCamera();
+
+	for (const RenderState::Item& item : state.getItems()) {
+		int x = static_cast<int>(item.position.x - camera.x);
+		int y = static_cast<int>(item.position.y - camera.y);
+		SDL_Rect dstRect = { x, y, static_cast<int>(item.size.width), static_cast<int>(item.size.height) };
+
+		switch (item.shape) {
+		case ShapeType::TEXTURE:
+			if (item.texturePath >= 0) {
+				SDL_RenderCopy(_renderer, TextureCache::getTexture(_renderer, state.getTexturePath(item.texturePath)), nullptr, &dstRect);
+			}
+			break;
+
+		case ShapeType::RECTANGLE: {
+			SDL_Texture* texture;
+			if (item.texturePath >= 0) {
+				texture = TextureCache::getTexture(_renderer, state.getTexturePath(item.texturePath));
+			}
+			else {
+				texture = getSolidTexture();
+				SDL_SetTextureColorMod(texture, item.color.r, item.color.g, item.color.b);
+				SDL_SetTextureAlphaMod(texture, item.color.a);
+			}
+			SDL_Point center = { dstRect.w / 2, dstRect.h / 2 };
+			SDL_RenderCopyEx(_renderer, texture, nullptr, &dstRect, item.rotationAngle, &center, SDL_FLIP_NONE);
+			break;
+		}
+
+		case ShapeType::CIRCLE: {
+			int radius = static_cast<int>(item.circleRadius);
+			SDL_SetRenderDrawColor(_renderer, item.color.r, item.color.g, item.color.b, item.color.a);
+			for (int dx = -radius; dx <= radius; dx++) {
+				for (int dy = -radius; dy <= radius; dy++) {
+					if (dx * dx + dy * dy <= radius * radius) SDL_RenderDrawPoint(_renderer, x + dx, y + dy);
+				}
+			}
+			break;
+		}
+
+		case ShapeType::TRIANGLE: {
+			int base = static_cast<int>(item.triangleBaseLength);
+			int height = static_cast<int>(item.triangleHeight);
+			SDL_Point points[3] = { { x, y }, { x + base, y }, { x + base / 2, y - height } };
+			SDL_SetRenderDrawColor(_renderer, item.color.r, item.color.g, item.color.b, item.color.a);
+			SDL_RenderDrawLines(_renderer, points, 3);
+			break;
+		}
+
+		default:
+			break;
+		}
+	}
+}
+
+// Rectangles without a texture share one white pixel, stretched and tinted, instead of a texture each
+SDL_Texture* Renderer::getSolidTexture() {
+	if (!_solidTexture) {
+		_solidTexture = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+		if (!_solidTexture) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture: %s", SDL_GetError());
+			return nullptr;
+		}
+		Uint32 white = 0xFFFFFFFF;
+		SDL_UpdateTexture(_solidTexture, nullptr, &white, sizeof(white));
+		SDL_SetTextureBlendMode(_solidTexture, SDL_BLENDMODE_BLEND);
+	}
+	return _solidTexture;
+}
@@ -6,6 +6,8 @@
 #include <SDL/SDL.h>
 #endif
 
+class RenderState;
+
 // Class, functions, varible signatures of the Rendere class. This class manages the renderer.
 class Renderer {
 public:
@@ -17,7 +19,12 @@ public:
 	void clear();
 	void present();
 	void shutdown();
+	// Draws a captured state relative to its camera, without touching any entity
+	void render(const RenderState& state);
 
 private:
+	SDL_Texture* getSolidTexture();
+
 	SDL_Renderer* _renderer;	
+	SDL_Texture* _solidTexture = nullptr;                        // 1x1 white, tinted to each rectangle's color
 };
@@ -0,0 +1,99 @@
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount) {
+	if (threadCount <= 0) {
+		threadCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	}
+
+	for (int i = 1; i < threadCount; i++) {
+		_workers.emplace_back([this, i]() { workerLoop(i); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_wakeUp.notify_all();
+
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+}
+
+int ThreadPool::getThreadCount() const {
+	return static_cast<int>(_workers.size()) + 1;
+}
+
+// Claims task indices until none are left
+void ThreadPool::runTasks(size_t threadIndex) {
+	size_t index;
+	while ((index = _nextIndex.fetch_add(1)) < _taskCount) {
+		try {
+			_invoke(_task, index, threadIndex);
+		}
+		catch (...) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_error) _error = std::current_exception();
+		}
+	}
+}
+
+// Waits for jobs and helps executing them
+void ThreadPool::workerLoop(size_t threadIndex) {
+	PROFILE_THREAD("Simulation worker " + std::to_string(threadIndex));
+	uint64_t seenGeneration = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeUp.wait(lock, [&]() { return _stopping || _generation != seenGeneration; });
+			if (_stopping) return;
+			seenGeneration = _generation;
+		}
+
+		runTasks(threadIndex);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_activeWorkers == 0) {
+			_done.notify_one();
+		}
+	}
+}
+
+void ThreadPool::run(size_t count, const void* task, Invoker invoke) {
+	if (count == 0) return;
+
+	// Nothing to gain from waking the workers for a single task
+	if (_workers.empty() || count == 1) {
+		for (size_t i = 0; i < count; i++) invoke(task, i, 0);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = task;
+		_invoke = invoke;
+		_taskCount = count;
+		_nextIndex = 0;
+		_activeWorkers = _workers.size();
+		_error = nullptr;
+		_generation++;
+	}
+	_wakeUp.notify_all();
+
+	runTasks(0);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done.wait(lock, [&]() { return _activeWorkers == 0; });
+	_task = nullptr;
+
+	if (_error) {
+		std::exception_ptr error = _error;
+		_error = nullptr;
+		std::rethrow_exception(error);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed pool of worker threads for fork-join parallelism inside a tick. The calling thread
+// takes part in the work, so a pool of N threads starts N - 1 workers.
+class ThreadPool {
+public:
+	explicit ThreadPool(int threadCount = 0);                              // 0 uses one thread per hardware core
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	void operator=(const ThreadPool&) = delete;
+
+	// Calls task(index, threadIndex) for every index in [0, count) and returns once all calls finished.
+	// threadIndex is in [0, getThreadCount()) and identifies the thread running the call, so tasks
+	// can write to per-thread buffers without locking. Exceptions are rethrown on the calling thread.
+	// The task is called through its address, so capturing lambdas are not copied into the heap.
+	template <typename Task>
+	void parallelFor(size_t count, const Task& task) {
+		run(count, &task, [](const void* job, size_t index, size_t threadIndex) {
+			(*static_cast<const Task*>(job))(index, threadIndex);
+			});
+	}
+
+	int getThreadCount() const;
+
+private:
+	using Invoker = void (*)(const void* task, size_t index, size_t threadIndex);
+
+	void run(size_t count, const void* task, Invoker invoke);
+	void workerLoop(size_t threadIndex);
+	void runTasks(size_t threadIndex);
+
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::condition_variable _wakeUp;
+	std::condition_variable _done;
+
+	const void* _task = nullptr;                                         // Job being executed
+	Invoker _invoke = nullptr;
+	size_t _taskCount = 0;
+	std::atomic<size_t> _nextIndex{ 0 };
+	size_t _activeWorkers = 0;                                           // Workers still running the current job
+	uint64_t _generation = 0;                                            // Incremented for every job
+	bool _stopping = false;
+	std::exception_ptr _error;
+};
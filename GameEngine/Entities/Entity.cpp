@@ -1,7 +1,9 @@
 #include "Entity.h"
 #include <string>
 #include <algorithm>
+#include <cmath>
 #include "TextureCache.h"
+#include "MemoryPool.h"
 
 #include "Renderer.h"
 #ifdef __APPLE__
@@ -10,7 +12,22 @@
 #include <SDL/SDL.h>
 #endif
 
-int Entity::_nextID = 0;
+std::atomic<int> Entity::_nextID{ 0 };
+
+static MemoryPool& entityPool() {
+    // Never destroyed, since entities may still be deleted by other statics at exit
+    static MemoryPool* pool = new MemoryPool(sizeof(Entity));
+    return *pool;
+}
+
+void* Entity::operator new(size_t size) {
+    return size == sizeof(Entity) ? entityPool().allocate() : ::operator new(size);
+}
+
+void Entity::operator delete(void* memory, size_t size) {
+    if (size == sizeof(Entity)) entityPool().deallocate(memory);
+    else ::operator delete(memory);
+}
 
 // Constructor for Rectangles
 Entity::Entity(Position position, Size size, SDL_Color color) {
@@ -62,6 +79,7 @@ Entity::Entity(const char *texturePath, Position position, Size size) {
 //}
 
 Entity::~Entity() {
+    EntityRegistry::getInstance().remove(_handle);
     shutdown();
 }
 
@@ -69,16 +87,38 @@ Entity::~Entity() {
 void Entity::generateEntityID() { _entityID = _nextID++; }
 void Entity::setEntityID(int id) { _entityID = id; }
 void Entity::setPosition(Position position) { _position = position; }
-void Entity::setOriginalPosition(Position position) { _originalPosition = position; }
-void Entity::setSize(Size size) { _size = size; }
+// Changes to what physics simulates wake a sleeping entity
+void Entity::setOriginalPosition(Position position) {
+    if (_isAsleep && (position.x != _originalPosition.x || position.y != _originalPosition.y)) wake();
+    _originalPosition = position;
+}
+void Entity::setSize(Size size) {
+    if (_isAsleep && (size.width != _size.width || size.height != _size.height)) wake();
+    _size = size;
+}
 void Entity::setOriginalSize(Size size) { _originalSize = size; }
-void Entity::setEntityType(EntityType entityType) { _entityType = entityType; }
+void Entity::setEntityType(EntityType entityType) {
+    if (_isAsleep && entityType != _entityType) wake();
+    _entityType = entityType;
+}
 void Entity::setZoneType(ZoneType zoneType) { _zoneType = zoneType; }
 void Entity::setShapeType(ShapeType shape) { _shape = shape; }
-void Entity::setVelocityX(float velocityX) { _velocity.x = velocityX; }
-void Entity::setVelocityY(float velocityY) { _velocity.y = velocityY; }
-void Entity::setAccelerationX(float accelerationX) { _acceleration.x = accelerationX; }
-void Entity::setAccelerationY(float accelerationY) { _acceleration.y = accelerationY; }
+void Entity::setVelocityX(float velocityX) {
+    if (_isAsleep && velocityX != _velocity.x) wake();
+    _velocity.x = velocityX;
+}
+void Entity::setVelocityY(float velocityY) {
+    if (_isAsleep && velocityY != _velocity.y) wake();
+    _velocity.y = velocityY;
+}
+void Entity::setAccelerationX(float accelerationX) {
+    if (_isAsleep && accelerationX != _acceleration.x) wake();
+    _acceleration.x = accelerationX;
+}
+void Entity::setAccelerationY(float accelerationY) {
+    if (_isAsleep && accelerationY != _acceleration.y) wake();
+    _acceleration.y = accelerationY;
+}
 void Entity::setCircleRadius(float radius) { _circleRadius = radius; }
 void Entity::setOriginalCircleRadius(float radius) { _originalCircleRadius = radius; }
 void Entity::setTriangleBaseLength(float baseLength) { _triangleBaseLength = baseLength; }
@@ -87,9 +127,11 @@ void Entity::setTriangleHeight(float height) { _triangleHeight = height; }
 void Entity::setOriginalTriangleHeight(float height) { _originalTriangleHeight = height; }
 void Entity::setColor(SDL_Color color) { _color = color; }
 void Entity::setEventDelay(int delay) { _eventDelay = delay; }
+void Entity::setStatic(bool isStatic) { _isStatic = isStatic; }
 
 // Getters
 int Entity::getEntityID() const { return _entityID; }
+EntityHandle Entity::getHandle() const { return _handle; }
 Position Entity::getPosition() const { return _position; }
 Position Entity::getOriginalPosition() const { return _originalPosition; }
 Size Entity::getOriginalSize() const { return _originalSize; }
@@ -106,6 +148,7 @@ float Entity::getTriangleBaseLength() const { return _triangleBaseLength; }
 float Entity::getTriangleHeight() const { return _triangleHeight; }
 SDL_Color Entity::getColor() const { return _color; }
 int Entity::getEventDelay() const { return _eventDelay; }
+bool Entity::isStatic() const { return _isStatic; }
 
 // Draws a rectangle
 void Entity::drawRectangle(SDL_Renderer* renderer, Position position) {
@@ -210,6 +253,36 @@ void Entity::applyScaling(float scaleX, float scaleY) {
     }
 }
 
+// Whether the physics system put the entity to sleep
+bool Entity::isAsleep() const { return _isAsleep; }
+
+// Makes physics and collision detection process the entity again
+void Entity::wake() {
+    _isAsleep = false;
+    _restingTicks = 0;
+}
+
+// Puts the entity to sleep after enough slow ticks in a row in which nothing accelerated it, or something held it
+bool Entity::rest(float velocityThreshold, int ticksToSleep, bool supported) {
+    bool accelerated = _acceleration.x != 0 || _acceleration.y != 0;
+    if (std::abs(_velocity.x) > velocityThreshold || std::abs(_velocity.y) > velocityThreshold || (accelerated && !supported)) {
+        _restingTicks = 0;
+        return false;
+    }
+    if (++_restingTicks < ticksToSleep) return false;
+
+    _velocity = {};
+    _isAsleep = true;
+    return true;
+}
+
+bool Entity::isColliding() const { return _isColliding; }
+void Entity::setColliding(bool isColliding) { _isColliding = isColliding; }
+int Entity::getWorldSlot() const { return _worldSlot; }
+void Entity::setWorldSlot(int slot) { _worldSlot = slot; }
+int Entity::getPhysicsSlot() const { return _physicsSlot; }
+void Entity::setPhysicsSlot(int slot) { _physicsSlot = slot; }
+
 // Teleports the entity to the position passed
 void Entity::teleportTo(const Position& position) {
     setPosition(position);
@@ -270,6 +343,13 @@ void Entity::shutdown() {
     }
 }
 
+// Drops the texture after a color or texture path change. Generated textures belong to the entity,
+// loaded ones to the TextureCache.
+void Entity::invalidateTexture() {
+    if (_texture && _texturePath.empty()) SDL_DestroyTexture(_texture);
+    _texture = nullptr;
+}
+
 // Converts entity type string into an enum variable
 EntityType stringToEntityType(const std::string& str) {
     if (str == "DEFAULT") return EntityType::DEFAULT;
@@ -287,6 +367,10 @@ ZoneType stringToZoneType(const std::string& str) {
     else return ZoneType::NONE;
 }
 
+bool hasStaticType(const Entity& entity) {
+    return entity.getEntityType() == EntityType::FIXED || entity.getZoneType() != ZoneType::NONE;
+}
+
 void Entity::setRotationAngle(float angle) { _rotationAngle = angle; }
 float Entity::getRotationAngle() const { return _rotationAngle; }
 void Entity::setTexturePath(const std::string& texturePath) { _texturePath = texturePath; }
@@ -2,6 +2,8 @@
 
 #include "Renderer.h"
 #include "Globals.h"
+#include "EntityRegistry.h"
+#include <atomic>
 #include <utility>
 #include <string>
 #include <iostream>
@@ -22,6 +24,14 @@ public:
 
     ~Entity();
 
+    // Entities are referred to by pointer and by handle, so they are never copied
+    Entity(const Entity&) = delete;
+    Entity& operator=(const Entity&) = delete;
+
+    // Entities come from a pool of fixed-size blocks instead of the heap (see MemoryPool)
+    static void* operator new(size_t size);
+    static void operator delete(void* memory, size_t size);
+
     // Setters    
     void setEntityID(int id);
     void setSize(Size size);
@@ -43,9 +53,12 @@ public:
     void setOriginalTriangleHeight(float height);
     void setColor(SDL_Color color);
     void setEventDelay(int delay);
+    void setStatic(bool isStatic);
 
     // Getters
     int getEntityID() const;
+    // Refers to this entity until it is destroyed (see EntityRegistry)
+    EntityHandle getHandle() const;
     Size getSize() const;
     Position getPosition() const;
     Position getOriginalPosition() const;
@@ -62,6 +75,7 @@ public:
     float getTriangleHeight() const;
     SDL_Color getColor() const;
     int getEventDelay() const;
+    bool isStatic() const;                                                                                      // Never moves unless explicitly modified (see hasStaticType)
     float getRotationAngle() const;
     const std::string& getTexturePath() const;
 
@@ -73,6 +87,28 @@ public:
     bool isWithinViewPort(const Camera& camera) const;
     void teleportTo(const Position& position);
     void shutdown();
+    void invalidateTexture();                                                                                   // Regenerate or reload the texture on the next render
+
+    // Sleep state, managed by the physics system. Asleep entities are skipped by physics and collision detection
+    // until another entity touches them or a setter changes their motion, position, size or type.
+    bool isAsleep() const;
+    void wake();
+    // Counts the ticks the entity moved slower than 'velocityThreshold' on both axes and stops it and puts it
+    // to sleep once there were 'ticksToSleep' in a row. A tick only counts if the entity has no acceleration or
+    // was 'supported' by a contact that cancelled it, so a body at the top of its jump stays awake.
+    // Returns true if it fell asleep.
+    bool rest(float velocityThreshold, int ticksToSleep, bool supported);
+
+    // Set by collision detection for entities that collided this tick, which physics leaves in place
+    bool isColliding() const;
+    void setColliding(bool isColliding);
+
+    // Index of the entity in the engine's entity list and in the physics system's list, kept by them so the
+    // entity can be removed in constant time. -1 if it is not in the list.
+    int getWorldSlot() const;
+    void setWorldSlot(int slot);
+    int getPhysicsSlot() const;
+    void setPhysicsSlot(int slot);
 
     void setRotationAngle(float angle);
     void setTexturePath(const std::string& texturePath);
@@ -107,12 +143,21 @@ private:
     void drawTriangle(SDL_Renderer* renderer, Position position);
 
     int _entityID;                                       // Unique ID of the entity
-    static int _nextID;                                  // Variable to track next available ID
+    static std::atomic<int> _nextID;                     // Next available ID, entities may be created on any thread
+    EntityHandle _handle = EntityRegistry::getInstance().add(this);
 
     int _eventDelay = 5;                                 // Optional variable to represent the delay for events this entity is involved in (Default is 5 seconds)
 
     float _rotationAngle = 0.0f;
+    bool _isStatic = false;                              // Left out of physics, snapshots and per-frame scaling
+    bool _isAsleep = false;
+    int _restingTicks = 0;                               // Consecutive ticks at rest (see rest)
+    bool _isColliding = false;
+    int _worldSlot = -1;
+    int _physicsSlot = -1;
 };
 
 EntityType stringToEntityType(const std::string& str);
-ZoneType stringToZoneType(const std::string& str);
\ No newline at end of file
+ZoneType stringToZoneType(const std::string& str);
+// FIXED entities and zones never move on their own. Engines mark them static unless they are given physics.
+bool hasStaticType(const Entity& entity);
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "EntityDelta.h"
+
+EntityDelta::EntityDelta(const EntityDelta& other) {
+    *this = other;
+}
+
+EntityDelta& EntityDelta::operator=(const EntityDelta& other) {
+    id = other.id;
+    fields = other.fields;
+    position = other.position;
+    size = other.size;
+    entityType = other.entityType;
+    zoneType = other.zoneType;
+    velocity = other.velocity;
+    acceleration = other.acceleration;
+    rotationAngle = other.rotationAngle;
+    color = other.color;
+    if (other.fields & TEXTURE_PATH) texturePath = other.texturePath;
+    else texturePath.clear();
+    return *this;
+}
+
+void EntityDelta::reset() {
+    id = -1;
+    fields = 0;
+    position = Position();
+    size = Size();
+    entityType = EntityType::DEFAULT;
+    zoneType = ZoneType::NONE;
+    velocity = Velocity();
+    acceleration = Acceleration();
+    rotationAngle = 0.0f;
+    color = { 255, 0, 0, 255 };
+    texturePath.clear();
+}
+
+void EntityDelta::capture(const Entity& entity) {
+    id = entity.getEntityID();
+    fields = ALL;
+    position = entity.getOriginalPosition();
+    size = entity.getOriginalSize();
+    entityType = entity.getEntityType();
+    zoneType = entity.getZoneType();
+    velocity = Velocity(entity.getVelocityX(), entity.getVelocityY());
+    acceleration = Acceleration(entity.getAccelerationX(), entity.getAccelerationY());
+    rotationAngle = entity.getRotationAngle();
+    color = entity.getColor();
+    texturePath = entity.getTexturePath();
+}
+
+uint32_t EntityDelta::diff(const Entity& entity) {
+    uint32_t changed = 0;
+    Position originalPosition = entity.getOriginalPosition();
+    Size originalSize = entity.getOriginalSize();
+    SDL_Color current = entity.getColor();
+
+    if (position.x != originalPosition.x || position.y != originalPosition.y) changed |= POSITION;
+    if (size.width != originalSize.width || size.height != originalSize.height) changed |= SIZE;
+    if (entityType != entity.getEntityType()) changed |= ENTITY_TYPE;
+    if (zoneType != entity.getZoneType()) changed |= ZONE_TYPE;
+    if (velocity.x != entity.getVelocityX() || velocity.y != entity.getVelocityY()) changed |= VELOCITY;
+    if (acceleration.x != entity.getAccelerationX() || acceleration.y != entity.getAccelerationY()) changed |= ACCELERATION;
+    if (rotationAngle != entity.getRotationAngle()) changed |= ROTATION;
+    if (color.r != current.r || color.g != current.g || color.b != current.b || color.a != current.a) changed |= COLOR;
+    if (texturePath != entity.getTexturePath()) changed |= TEXTURE_PATH;
+
+    fields &= changed;
+    return fields;
+}
+
+void EntityDelta::applyTo(Entity& entity) const {
+    if (fields & POSITION) {
+        entity.setPosition(position);
+        entity.setOriginalPosition(position);
+    }
+    if (fields & SIZE) {
+        entity.setSize(size);
+        entity.setOriginalSize(size);
+    }
+    if (fields & ENTITY_TYPE) entity.setEntityType(entityType);
+    if (fields & ZONE_TYPE) entity.setZoneType(zoneType);
+    if (fields & VELOCITY) {
+        entity.setVelocityX(velocity.x);
+        entity.setVelocityY(velocity.y);
+    }
+    if (fields & ACCELERATION) {
+        entity.setAccelerationX(acceleration.x);
+        entity.setAccelerationY(acceleration.y);
+    }
+    if (fields & ROTATION) entity.setRotationAngle(rotationAngle);
+
+    // The texture is regenerated on the next render when its look changes
+    if (fields & (COLOR | TEXTURE_PATH)) entity.invalidateTexture();
+    if (fields & COLOR) entity.setColor(color);
+    if (fields & TEXTURE_PATH) entity.setTexturePath(texturePath);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Entity.h"
+#include "Globals.h"
+#include <cstdint>
+#include <string>
+
+// State of one entity as carried by a snapshot, decoded without creating an Entity. 'fields' marks which
+// members are set; after diff() it only marks the ones that differ from the entity the update targets.
+struct EntityDelta {
+    enum Field : uint32_t {
+        POSITION = 1 << 0,
+        SIZE = 1 << 1,
+        ENTITY_TYPE = 1 << 2,
+        ZONE_TYPE = 1 << 3,
+        VELOCITY = 1 << 4,
+        ACCELERATION = 1 << 5,
+        ROTATION = 1 << 6,
+        COLOR = 1 << 7,
+        TEXTURE_PATH = 1 << 8,
+        ALL = (1 << 9) - 1
+    };
+
+    int id = -1;
+    uint32_t fields = 0;
+    Position position;
+    Size size;
+    EntityType entityType = EntityType::DEFAULT;
+    ZoneType zoneType = ZoneType::NONE;
+    Velocity velocity;
+    Acceleration acceleration;
+    float rotationAngle = 0.0f;
+    SDL_Color color = { 255, 0, 0, 255 };
+    std::string texturePath;                                 // Only meaningful when TEXTURE_PATH is set
+
+    EntityDelta() = default;
+    // Copies only the fields that are set, so deltas without a texture path stay allocation free
+    EntityDelta(const EntityDelta& other);
+    EntityDelta& operator=(const EntityDelta& other);
+
+    // Clears the fields, keeping the texture path's capacity for the next decode
+    void reset();
+    // Sets every field to the value of 'entity'
+    void capture(const Entity& entity);
+    // Keeps only the fields that differ from 'entity'. Returns the remaining fields.
+    uint32_t diff(const Entity& entity);
+    // Writes the fields that are set into 'entity'. Positions and sizes are written as the entity's
+    // original (unscaled) values, like the server sends them.
+    void applyTo(Entity& entity) const;
+};
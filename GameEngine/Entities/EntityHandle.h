@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+// Refers to an entity through the EntityRegistry. The index names a registry slot and the generation tells
+// apart the entities that used the slot, so a handle that outlives its entity resolves to nullptr instead
+// of dangling.
+struct EntityHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool isNull() const { return index == UINT32_MAX; }
+    bool operator==(const EntityHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const EntityHandle& other) const { return !(*this == other); }
+};
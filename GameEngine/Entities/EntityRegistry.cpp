@@ -0,0 +1,61 @@
+#include "EntityRegistry.h"
+#include <stdexcept>
+
+EntityRegistry& EntityRegistry::getInstance() {
+    static EntityRegistry* instance = new EntityRegistry();
+    return *instance;
+}
+
+EntityHandle EntityRegistry::add(Entity* entity) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    uint32_t index;
+    if (!_freeSlots.empty()) {
+        index = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+    else {
+        index = _slotCount;
+        if (index % CHUNK_SIZE == 0) {
+            if (index >> CHUNK_SHIFT >= MAX_CHUNKS) throw std::runtime_error("Too many entities");
+            _chunks[index >> CHUNK_SHIFT].store(new Slot[CHUNK_SIZE], std::memory_order_release);
+        }
+        _slotCount++;
+    }
+
+    // The generation was bumped when the slot was freed; publishing the entity after it lets get() tell
+    // the new entity from the old one
+    Slot& slot = _chunks[index >> CHUNK_SHIFT].load(std::memory_order_relaxed)[index % CHUNK_SIZE];
+    slot.entity.store(entity, std::memory_order_release);
+    _size++;
+    return { index, slot.generation.load(std::memory_order_relaxed) };
+}
+
+void EntityRegistry::remove(EntityHandle handle) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (handle.index >= _slotCount) return;
+
+    Slot& slot = _chunks[handle.index >> CHUNK_SHIFT].load(std::memory_order_relaxed)[handle.index % CHUNK_SIZE];
+    if (slot.generation.load(std::memory_order_relaxed) != handle.generation || !slot.entity.load(std::memory_order_relaxed)) return;
+
+    slot.entity.store(nullptr, std::memory_order_relaxed);
+    slot.generation.store(handle.generation + 1, std::memory_order_release);
+    _freeSlots.push_back(handle.index);
+    _size--;
+}
+
+// Reads the generation on both sides of the entity, so an entity that replaced the handle's one in the
+// meantime is never returned
+Entity* EntityRegistry::get(EntityHandle handle) const {
+    if (handle.index >> CHUNK_SHIFT >= MAX_CHUNKS) return nullptr;
+    const Slot* chunk = _chunks[handle.index >> CHUNK_SHIFT].load(std::memory_order_acquire);
+    if (!chunk) return nullptr;
+
+    const Slot& slot = chunk[handle.index % CHUNK_SIZE];
+    if (slot.generation.load(std::memory_order_acquire) != handle.generation) return nullptr;
+    Entity* entity = slot.entity.load(std::memory_order_acquire);
+    return slot.generation.load(std::memory_order_acquire) == handle.generation ? entity : nullptr;
+}
+
+size_t EntityRegistry::size() const {
+    return _size;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "EntityHandle.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+class Entity;
+
+// Slot allocator behind EntityHandle. Every entity takes a slot when it is constructed and frees it when it
+// is destroyed. Freed slots are reused with the next generation, so lookups stay O(1) and old handles to a
+// slot stop resolving. Safe to call from any thread; only add and remove take a lock.
+class EntityRegistry {
+public:
+    // The registry is never destroyed, since entities may outlive other statics at exit
+    static EntityRegistry& getInstance();
+
+    EntityRegistry(const EntityRegistry&) = delete;
+    void operator=(const EntityRegistry&) = delete;
+
+    EntityHandle add(Entity* entity);
+    // Frees the handle's slot. Does nothing if the handle is stale.
+    void remove(EntityHandle handle);
+    // The entity the handle refers to, or nullptr if it was destroyed. Never blocks.
+    Entity* get(EntityHandle handle) const;
+    // Number of live entities
+    size_t size() const;
+
+private:
+    EntityRegistry() = default;
+
+    // Slots live in chunks that are never moved or freed, so lookups can read them while slots are added
+    static const uint32_t CHUNK_SHIFT = 12;
+    static const uint32_t CHUNK_SIZE = 1u << CHUNK_SHIFT;
+    static const uint32_t MAX_CHUNKS = 1u << 12;
+
+    struct Slot {
+        std::atomic<Entity*> entity{ nullptr };
+        std::atomic<uint32_t> generation{ 0 };
+    };
+
+    std::mutex _mutex;                                       // Serializes add and remove
+    std::atomic<Slot*> _chunks[MAX_CHUNKS] = {};
+    uint32_t _slotCount = 0;
+    std::vector<uint32_t> _freeSlots;                        // Slots to reuse, most recently freed last
+    std::atomic<size_t> _size{ 0 };
+};
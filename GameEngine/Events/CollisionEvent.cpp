@@ -1,17 +1,19 @@
 #include "Event.h"
 #include "Entity.h"
 
+// Refers to the entities by handle, since they may be destroyed before the event is processed
 class CollisionEvent final : public Event {
     public:
     explicit CollisionEvent(Entity* entityA, Entity* entityB)
-        : _entityA(entityA), _entityB(entityB) {}
+        : _entityA(entityA->getHandle()), _entityB(entityB->getHandle()) {}
     
     EventType getType() const override { return EventType::Collision; }
 
-    Entity* getEntityA() const { return _entityA; }
-    Entity* getEntityB() const { return _entityB; }
+    // nullptr if the entity was destroyed since
+    Entity* getEntityA() const { return EntityRegistry::getInstance().get(_entityA); }
+    Entity* getEntityB() const { return EntityRegistry::getInstance().get(_entityB); }
 
 private:
-    Entity* _entityA;
-    Entity* _entityB;
+    EntityHandle _entityA;
+    EntityHandle _entityB;
 };
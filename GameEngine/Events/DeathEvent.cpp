@@ -1,17 +1,19 @@
 #include "Event.h"
 #include "Entity.h"
 
+// Refers to the entity by handle, since the event is delayed and the entity may be destroyed meanwhile
 class DeathEvent final : public Event {
 public:
     explicit DeathEvent(Entity* entity, Position respawnPosition)
-        : _entity(entity), _respawnPosition(respawnPosition) {}
+        : _entity(entity->getHandle()), _respawnPosition(respawnPosition) {}
 
     EventType getType() const override { return EventType::Death; }
 
-    Entity* getEntity() const { return _entity; }
+    // nullptr if the entity was destroyed since
+    Entity* getEntity() const { return EntityRegistry::getInstance().get(_entity); }
     Position getRespawnPosition() const { return _respawnPosition; }
 
 private:
-    Entity* _entity;
+    EntityHandle _entity;
     Position _respawnPosition;
 };
@@ -1,23 +1,22 @@
 #pragma once
 
 #include "Event.h"
-#include "Entity.h"
+#include "EntityDelta.h"
 
+// Raised by the client for every entity a snapshot changed. Carries only the changed fields; the entity
+// itself has already been updated when the event is processed.
 class EntityUpdateEvent final : public Event {
 public:
-    explicit EntityUpdateEvent(Entity* entity): _entity(new Entity(*entity)) {}
-
-    EntityUpdateEvent(const EntityUpdateEvent& other) : _entity(new Entity(*other._entity)) {}
+    explicit EntityUpdateEvent(const EntityDelta& delta): _delta(delta) {}
 
     EventType getType() const override { return EventType::EntityUpdate; }
 
-    Entity* getEntity() const { return _entity; }
-    void setEntity(Entity* entity) { _entity = entity; }
+    const EntityDelta& getDelta() const { return _delta; }
 
     bool isReplay() const { return _isReplay; }
     void setIsReplay(const bool isReplay) { _isReplay = isReplay; }
 
 private:
-    Entity* _entity;
+    EntityDelta _delta;
     bool _isReplay = false;
-};
\ No newline at end of file
+};
@@ -5,6 +5,7 @@
 #ifndef EVENT_H
 #define EVENT_H
 #include <Globals.h>
+#include <cstddef>
 
 class Event {
 public:
@@ -13,6 +14,10 @@ public:
 
     virtual ~Event() = default;
 
+    // Events come from a pool of fixed-size blocks instead of the heap, since many are raised every tick
+    static void* operator new(size_t size);
+    static void operator delete(void* memory, size_t size);
+
     void setTimestamp(const long long timestamp) { _timestamp = timestamp; }
     long long getTimestamp() const { return _timestamp; }
 
@@ -3,11 +3,38 @@
 //
 
 #include "EventManager.h"
+#include "MemoryPool.h"
+#include "Profiler.h"
+
+// Large enough for every event type of the engine; bigger events come from the heap
+static const size_t EVENT_BLOCK_SIZE = 128;
+
+static MemoryPool& eventPool() {
+    // Never destroyed, since events may still be deleted by other statics at exit
+    static MemoryPool* pool = new MemoryPool(EVENT_BLOCK_SIZE, 1024);
+    return *pool;
+}
+
+void* Event::operator new(size_t size) {
+    return size <= EVENT_BLOCK_SIZE ? eventPool().allocate() : ::operator new(size);
+}
+
+void Event::operator delete(void* memory, size_t size) {
+    if (size <= EVENT_BLOCK_SIZE) eventPool().deallocate(memory);
+    else ::operator delete(memory);
+}
 
 // Constructor
 EventManager::EventManager(Timeline* timeline)
     : _timeline(timeline) {}
 
+EventManager::~EventManager() {
+    while (!_eventQueue.empty()) {
+        delete _eventQueue.top();
+        _eventQueue.pop();
+    }
+}
+
 // Register an event handler for a specific event type
 void EventManager::registerHandler(const EventType eventType, const EventHandler& handler) {
     _handlers[eventType].push_back(handler);
@@ -17,25 +44,34 @@ void EventManager::registerHandler(const EventType eventType, const EventHandler
 void EventManager::raiseEvent(Event* event) {
     event->setTimestamp(_timeline->getTime());
     _eventQueue.push(event);
+    _raisedCount++;
+    _queueSize = _eventQueue.size();
 }
 
 void EventManager::raiseRawEvent(Event* event) {
     _eventQueue.push(event);
+    _raisedCount++;
+    _queueSize = _eventQueue.size();
 }
 
 void EventManager::raiseEventWithDelay(Event* event, const int delay) {
     event->setTimestamp(_timeline->getTime() + static_cast<int64_t>(delay) * 1'000'000'000);
     _eventQueue.push(event);
+    _raisedCount++;
+    _queueSize = _eventQueue.size();
 }
 
 // Process and handle events that are due based on the timeline
 void EventManager::process() {
+    PROFILE_ZONE("EventManager::process");
     while (!_eventQueue.empty()) {
        const auto event = _eventQueue.top();
 
         // Process events that are due based on timestamp
         if (event->getTimestamp() <= _timeline->getTime()) {
             _eventQueue.pop();
+            _processedCount++;
+            _queueSize = _eventQueue.size();
 
             // Find and execute all handlers for this event type
             auto it = _handlers.find(event->getType());
@@ -44,8 +80,13 @@ void EventManager::process() {
                     handler(event);
                 }
             }
+            delete event;
         } else {
             break;  // Future events will be handled later
         }
     }
-}
\ No newline at end of file
+}
+
+uint64_t EventManager::getRaisedCount() const { return _raisedCount; }
+uint64_t EventManager::getProcessedCount() const { return _processedCount; }
+size_t EventManager::getQueueSize() const { return _queueSize; }
@@ -5,6 +5,7 @@
 #ifndef EVENT_MANAGER_H
 #define EVENT_MANAGER_H
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
 #include <vector>
@@ -26,11 +27,14 @@ class EventManager {
 public:
     // Constructor
     explicit EventManager(Timeline* timeline);
+    // Deletes the events that are still queued
+    ~EventManager();
 
     // Register an event handler for a specific event type
     void registerHandler(EventType eventType, const EventHandler& handler);
 
-    // Raise an event by adding it to the event queue
+    // Raise an event by adding it to the event queue. The manager owns raised events and deletes each
+    // one after its handlers ran, so handlers must not keep or delete it.
     void raiseEvent(Event* event);
 
     void raiseRawEvent(Event *event);
@@ -41,6 +45,11 @@ public:
     // Process and handle events that are due based on the timeline
     void process();
 
+    // Counters for monitoring. Safe to read from any thread.
+    uint64_t getRaisedCount() const;
+    uint64_t getProcessedCount() const;
+    size_t getQueueSize() const;
+
 private:
     Timeline* _timeline;
     std::priority_queue<Event*,
@@ -48,6 +57,9 @@ private:
                         EventComparator> _eventQueue;
     std::unordered_map<EventType, std::vector<EventHandler>> _handlers;
     std::mutex _eventQueueMutex;
+    std::atomic<uint64_t> _raisedCount{ 0 };
+    std::atomic<uint64_t> _processedCount{ 0 };
+    std::atomic<size_t> _queueSize{ 0 };
 };
 
 #endif // EVENT_MANAGER_H
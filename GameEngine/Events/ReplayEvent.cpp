@@ -1,24 +1,20 @@
 #include "Event.h"
-#include "Entity.h"
+#include "EntityDelta.h"
 #include "EntityUpdateEvent.cpp"
 
 class ReplayEvent final : public Event {
 public:
     explicit ReplayEvent(const EntityUpdateEvent* event)
-        : Event(event->getTimestamp()), _entity(new Entity(*event->getEntity())), _isReplay(false) {}
-
-    ReplayEvent(const ReplayEvent& other)
-        : Event(other.getTimestamp()), _entity(other.getEntity()), _isReplay(other.isReplay()) {}
+        : Event(event->getTimestamp()), _delta(event->getDelta()), _isReplay(false) {}
 
     EventType getType() const override { return EventType::Replay; }
 
-    Entity* getEntity() const { return _entity; }
-    void setEntity(Entity* entity) { _entity = entity; }
+    const EntityDelta& getDelta() const { return _delta; }
 
     bool isReplay() const { return _isReplay; }
     void setIsReplay(const bool isReplay) { _isReplay = isReplay; }
 
 private:
-    Entity* _entity;
+    EntityDelta _delta;
     bool _isReplay;
-};
\ No newline at end of file
+};
@@ -1,18 +1,20 @@
 #include "Event.h"
 #include "Entity.h"
 
+// Refers to the entity by handle, since it may be destroyed before the event is processed
 class SpawnEvent final : public Event {
 public:
     explicit SpawnEvent(Entity* entity, const Position& position)
-        : _entity(entity), _position(position) {}
+        : _entity(entity->getHandle()), _position(position) {}
 
     EventType getType() const override { return EventType::Spawn; }
 
-    Entity* getEntity() const { return _entity; }
+    // nullptr if the entity was destroyed since
+    Entity* getEntity() const { return EntityRegistry::getInstance().get(_entity); }
 
     Position getPosition() const { return _position; }
 
 private:
-    Entity* _entity;
+    EntityHandle _entity;
     Position _position;
-};
\ No newline at end of file
+};
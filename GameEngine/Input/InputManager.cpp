@@ -8,6 +8,8 @@
 #include <EventManager.h>
 
 #include "InputEvent.cpp"
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 InputManager::InputManager(const bool considerPrevKeys) : _considerPrevKeys(considerPrevKeys) {}
@@ -1,5 +1,9 @@
 #include "Client.h"
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <string>
 #include <thread>
 #ifdef __APPLE__
@@ -9,15 +13,35 @@
 #endif
 
 #include "EventManager.h"
+#include "SessionManager.h"
+#include "Server.h"
+#include "ServerHost.h"
+#include "WorldBlob.h"
+#include "MessagePool.h"
+#include "EntityDelta.h"
 #include "EntityUpdateEvent.cpp"
+#include "Profiler.h"
 
 Client::Client() {    
 	_context = zmq::context_t(1);
-	_publisher = zmq::socket_t(_context, zmq::socket_type::pub);
-	_heartbeatPublisher = zmq::socket_t(_context, zmq::socket_type::pub);
-    _entitySubscriber = zmq::socket_t(_context, zmq::socket_type::sub);
-	_subscriber = zmq::socket_t(_context, zmq::socket_type::sub);
-    _requester = zmq::socket_t(_context, zmq::socket_type:: req);
+    createSockets(_context);
+}
+
+Client::Client(zmq::context_t& context) {
+    createSockets(context);
+
+    // Pending messages must not hold up the shutdown of the shared context
+    for (zmq::socket_t* socket : { &_publisher, &_heartbeatPublisher, &_entitySubscriber, &_subscriber, &_requester }) {
+        socket->set(zmq::sockopt::linger, 0);
+    }
+}
+
+void Client::createSockets(zmq::context_t& context) {
+	_publisher = zmq::socket_t(context, zmq::socket_type::pub);
+	_heartbeatPublisher = zmq::socket_t(context, zmq::socket_type::pub);
+    _entitySubscriber = zmq::socket_t(context, zmq::socket_type::sub);
+	_subscriber = zmq::socket_t(context, zmq::socket_type::sub);
+    _requester = zmq::socket_t(context, zmq::socket_type:: req);
     _gameState = GameState::PLAY;
     setRefreshRate();
 
@@ -29,19 +53,27 @@ Client::~Client() {
     _heartbeatPublisher.close();
 	_subscriber.close();
     _entitySubscriber.close();
+    _requester.close();
 }
 
 // Initializes the client. Binds ports into pub-sub and req-rep models.
 void Client::initialize(int pubPort, int entitySubPort, int reqPort, int heartbearPort, int subPort) {    
 
-    _publisher.connect("tcp://localhost:" + std::to_string(pubPort));   
-    _heartbeatPublisher.connect("tcp://localhost:" + std::to_string(heartbearPort));
-    _entitySubscriber.connect("tcp://localhost:" + std::to_string(entitySubPort));
-    _subscriber.connect("tcp://localhost:" + std::to_string(subPort));
-    _requester.connect("tcp://localhost:" + std::to_string(reqPort));  
-    _entitySubscriber.set(zmq::sockopt::subscribe, "");
-    _subscriber.set(zmq::sockopt::subscribe, "");
+    std::string address = "tcp://" + _serverHost + ":";
+    _publisher.connect(address + std::to_string(pubPort));   
+    _heartbeatPublisher.connect(address + std::to_string(heartbearPort));
+    _entitySubscriber.connect(address + std::to_string(entitySubPort));
+    _subscriber.connect(address + std::to_string(subPort));
+    _requester.connect(address + std::to_string(reqPort));  
+    _subscriber.set(zmq::sockopt::subscribe, _topic);
+
+    // A plain Server sends snapshots on a topic per client, which is subscribed to once the client ID is known
+    if (_roomID >= 0) {
+        _entityTopic = _topic;
+        _entitySubscriber.set(zmq::sockopt::subscribe, _entityTopic);
+    }
 
+    if (!_verbose) return;
     printf("Client initialized.\n");
     printf("Connected to server on ports:\n");
     printf("Publisher port: %d\n", pubPort);
@@ -54,8 +86,11 @@ void Client::initialize(int pubPort, int entitySubPort, int reqPort, int heartbe
 // Retreives client ID and initial world information from server
 bool Client::handshakeWithServer() {
     try {
-        zmq::message_t request("CONNECT", 7);  // Request to connect
+        std::string cachedWorld = loadCachedWorld();
+        std::string connectRequest = WorldBlob::formatConnectRequest(_roomID, WorldBlob::hashOf(cachedWorld), _bandwidth);
+        zmq::message_t request(connectRequest.data(), connectRequest.size());  // Request to connect
         _requester.send(request, zmq::send_flags::none);
+        _bytesSent.fetch_add(connectRequest.size(), std::memory_order_relaxed);
 
         zmq::message_t reply;  // Response from server
         auto result = _requester.recv(reply, zmq::recv_flags::none);
@@ -65,33 +100,61 @@ bool Client::handshakeWithServer() {
             return false;
         }
 
-        std::string response(static_cast<char*>(reply.data()), reply.size());        
+        const char* response = static_cast<const char*>(reply.data());
+        size_t responseSize = reply.size();
+        _bytesReceived += responseSize;
 
-        // Validate response format (expected format: "clientID|assignedEntityID|entityData")
-        size_t firstSeparator = response.find("|");
-        size_t secondSeparator = response.find("|", firstSeparator + 1);
+        // Validate response format (expected format: "clientID|assignedEntityID|world")
+        const char* firstSeparator = static_cast<const char*>(memchr(response, '|', responseSize));
+        const char* secondSeparator = firstSeparator ? static_cast<const char*>(memchr(firstSeparator + 1, '|', response + responseSize - firstSeparator - 1)) : nullptr;
 
-        if (firstSeparator == std::string::npos || secondSeparator == std::string::npos) {
+        if (!firstSeparator || !secondSeparator) {
             printf("Invalid response format from server.\n");
             return false;
         }
 
         // Extract client ID and assigned entity ID
-        setClientID(std::stoi(response.substr(0, firstSeparator)));
-        _entityID = std::stoi(response.substr(firstSeparator + 1, secondSeparator - firstSeparator - 1));
-        std::string entityData = response.substr(secondSeparator + 1);
-
-        // Parse entity data and deserialize entities
-        size_t pos = 0;
-        while ((pos = entityData.find("\n")) != std::string::npos) {
-            std::string serializedEntity = entityData.substr(0, pos);
-            Entity* entity = deserializeEntity(serializedEntity);
-            if (entity) {
-                _entities.push_back(entity);
+        setClientID(std::stoi(std::string(response, firstSeparator)));
+        _entityID = std::stoi(std::string(firstSeparator + 1, secondSeparator));
+        if (_roomID < 0) {
+            _entityTopic = Server::clientTopic(_clientID);
+            _entitySubscriber.set(zmq::sockopt::subscribe, _entityTopic);
+        }
+
+        // The static world is only sent if the cached one is missing or outdated
+        std::string staticWorld, dynamicWorld;
+        uint64_t staticHash = 0;
+        if (!WorldBlob::parseHandshake(secondSeparator + 1, response + responseSize - secondSeparator - 1, staticWorld, staticHash, dynamicWorld)) {
+            printf("Invalid world data from server.\n");
+            return false;
+        }
+        if (staticWorld.empty()) {
+            if (WorldBlob::hashOf(cachedWorld) != staticHash) {
+                printf("Server skipped a world that is not cached.\n");
+                return false;
             }
-            entityData.erase(0, pos + 1);
-        }        
+            staticWorld.swap(cachedWorld);
+        }
+        else {
+            storeCachedWorld(staticWorld);
+        }
 
+        size_t firstStatic = _entities.size();
+        bool decoded = WorldBlob::decode(staticWorld.data(), staticWorld.size(), _entities);
+        size_t firstDynamic = _entities.size();
+        if (!decoded || !WorldBlob::decode(dynamicWorld.data(), dynamicWorld.size(), _entities)) {
+            printf("Corrupt world data from server.\n");
+            return false;
+        }
+
+        // The server leaves these out of snapshots and sends them again only when they are modified
+        for (size_t i = firstStatic; i < firstDynamic; i++) {
+            _entities[i]->setStatic(hasStaticType(*_entities[i]));
+        }
+        _staticRevision++;
+        indexEntities();
+
+        if (!_verbose) return true;
         printf("Successfully connected to server with Client ID: %d, Assigned Entity ID: %d\n", _clientID, _entityID);
         printf("Received %d entities from server.\n", static_cast<int>(_entities.size()));
         return true;
@@ -106,36 +169,93 @@ bool Client::handshakeWithServer() {
     }
 }
 
-// Sends heartbeat messages to the server
+// Static worlds received by the clients of this process, by server and room
+static std::mutex worldCacheMutex;
+static std::map<std::string, std::string> worldCache;
+
+std::string Client::worldCacheKey() const {
+    return _serverHost + "-" + std::to_string(_roomID);
+}
+
+// Returns the cached static world of the server (and room) this client connects to, or an empty string
+std::string Client::loadCachedWorld() {
+    std::string key = worldCacheKey();
+    {
+        std::lock_guard<std::mutex> lock(worldCacheMutex);
+        auto it = worldCache.find(key);
+        if (it != worldCache.end()) return it->second;
+    }
+    if (_worldCacheDirectory.empty()) return "";
+
+    std::ifstream file(_worldCacheDirectory + "/world-" + key + ".bin", std::ios::binary);
+    std::string blob((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!WorldBlob::verify(blob)) return "";
+
+    std::lock_guard<std::mutex> lock(worldCacheMutex);
+    worldCache[key] = blob;
+    return blob;
+}
+
+void Client::storeCachedWorld(const std::string& blob) {
+    std::string key = worldCacheKey();
+    {
+        std::lock_guard<std::mutex> lock(worldCacheMutex);
+        worldCache[key] = blob;
+    }
+    if (_worldCacheDirectory.empty()) return;
+
+    std::ofstream file(_worldCacheDirectory + "/world-" + key + ".bin", std::ios::binary | std::ios::trunc);
+    file.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+}
+
+// Returns the current steady clock time in ns
+static int64_t steadyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+// Records that a message was sent to the server. Any message keeps the session alive.
+void Client::markSent(size_t bytes) {
+    _lastSendTime.store(steadyNow(), std::memory_order_relaxed);
+    _bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// Sends a heartbeat message to the server, unless other traffic already kept the session alive
+// within the heartbeat interval. Cheap to call every frame.
 void Client::sendHeartbeatToServer() {    
-    json heartbeatMessage = {
-        {"type", "heartbeat"},
-        {"clientId", _clientID}
-    };
-    
-    std::string message = heartbeatMessage.dump();
+    PROFILE_ZONE("Client::sendHeartbeatToServer");
+    int64_t now = steadyNow();
+    int64_t intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(_heartbeatInterval).count();
+    if (now - _lastSendTime.load(std::memory_order_relaxed) < intervalNs) return;
+
+    std::string message = SessionManager::formatHeartbeat(_clientID);
    
-    zmq::message_t zmqMessage(message.size());
-    memcpy(zmqMessage.data(), message.c_str(), message.size());
+    zmq::message_t zmqMessage(message.data(), message.size());      // Small enough to be stored inline by ZMQ
     _heartbeatPublisher.send(zmqMessage, zmq::send_flags::none);
+    _lastSendTime.store(now, std::memory_order_relaxed);
+    _bytesSent.fetch_add(message.size(), std::memory_order_relaxed);
 }
 
 
 // Sends keypresses to the server
 void Client::sendInputToServer(const std::string& buttonPress) {
+    PROFILE_ZONE("Client::sendInputToServer");
+    uint32_t sequence = ++_inputSequence;
+    _inputSendTimes[sequence % INPUT_HISTORY] = std::chrono::steady_clock::now();
+
     json keypressMessage = {
         {"type", "keypress"},
         {"clientId", _clientID},
-        {"buttonPress", buttonPress}
+        {"buttonPress", buttonPress},
+        {"seq", sequence}
     };
     
     std::string message = keypressMessage.dump();
-    
-    zmq::message_t zmqMessage(message.size());
-    memcpy(zmqMessage.data(), message.c_str(), message.size());
-    _publisher.send(zmqMessage, zmq::send_flags::none);
+    markSent(message.size());
+    _publisher.send(MessagePool::getInstance().wrap(message), zmq::send_flags::none);
 
-    printf("Sent input to server: %s\n", buttonPress.c_str());
+    if (_verbose) printf("Sent input to server: %s\n", buttonPress.c_str());
 }
 
 Entity* jsonToEntity(json jsonEntity) {
@@ -190,104 +310,315 @@ std::vector<std::string> split(const std::string& str, const std::string& delimi
     return tokens;
 }
 
-// Function to parse a key-value string into an Entity
-Entity* stringToEntity(const std::string& entityString) {
+// Parses a key-value entity string into a delta
+static void stringToDelta(const std::string& entityString, EntityDelta& delta) {
     std::istringstream iss(entityString);
     std::string token;
-    Entity* entity = new Entity(Position(0, 0), Size(0, 0)); // Default entity
+    delta.reset();
 
     while (std::getline(iss, token, '|')) {
         size_t dashPos = token.find(':');
         std::string key = token.substr(0, dashPos);
         std::string value = token.substr(dashPos + 1);
 
-        // Set entity properties based on key-value pairs
-        if (key == "id") entity->setEntityID(std::stoi(value));
-        else if (key == "x") entity->setPosition(Position(std::stof(value), entity->getPosition().y));
-        else if (key == "y") entity->setPosition(Position(entity->getPosition().x, std::stof(value)));
-        else if (key == "width") entity->setSize(Size(std::stof(value), entity->getSize().height));
-        else if (key == "height") entity->setSize(Size(entity->getSize().width, std::stof(value)));
-        else if (key == "type") entity->setEntityType(stringToEntityType(value));
-        else if (key == "zoneType") entity->setZoneType(stringToZoneType(value));
-        else if (key == "velocityX") entity->setVelocityX(std::stof(value));
-        else if (key == "velocityY") entity->setVelocityY(std::stof(value));
-        else if (key == "accelerationX") entity->setAccelerationX(std::stof(value));
-        else if (key == "accelerationY") entity->setAccelerationY(std::stof(value));
-        else if (key == "rotationAngle") entity->setRotationAngle(std::stof(value));
-        else if (key == "texturePath") entity->setTexturePath(value);
-        else if (key == "cr") entity->setColor(SDL_Color{ static_cast<uint8_t>(std::stoi(value)), entity->getColor().g, entity->getColor().b, entity->getColor().a });
-        else if (key == "cg") entity->setColor(SDL_Color{ entity->getColor().r, static_cast<uint8_t>(std::stoi(value)), entity->getColor().b, entity->getColor().a });
-        else if (key == "cb") entity->setColor(SDL_Color{ entity->getColor().r, entity->getColor().g, static_cast<uint8_t>(std::stoi(value)), entity->getColor().a });
-        else if (key == "ca") entity->setColor(SDL_Color{ entity->getColor().r, entity->getColor().g, entity->getColor().b, static_cast<uint8_t>(std::stoi(value)) });
+        if (key == "id") delta.id = std::stoi(value);
+        else if (key == "x") { delta.position.x = std::stof(value); delta.fields |= EntityDelta::POSITION; }
+        else if (key == "y") { delta.position.y = std::stof(value); delta.fields |= EntityDelta::POSITION; }
+        else if (key == "width") { delta.size.width = std::stof(value); delta.fields |= EntityDelta::SIZE; }
+        else if (key == "height") { delta.size.height = std::stof(value); delta.fields |= EntityDelta::SIZE; }
+        else if (key == "type") { delta.entityType = stringToEntityType(value); delta.fields |= EntityDelta::ENTITY_TYPE; }
+        else if (key == "zoneType") { delta.zoneType = stringToZoneType(value); delta.fields |= EntityDelta::ZONE_TYPE; }
+        else if (key == "velocityX") { delta.velocity.x = std::stof(value); delta.fields |= EntityDelta::VELOCITY; }
+        else if (key == "velocityY") { delta.velocity.y = std::stof(value); delta.fields |= EntityDelta::VELOCITY; }
+        else if (key == "accelerationX") { delta.acceleration.x = std::stof(value); delta.fields |= EntityDelta::ACCELERATION; }
+        else if (key == "accelerationY") { delta.acceleration.y = std::stof(value); delta.fields |= EntityDelta::ACCELERATION; }
+        else if (key == "rotationAngle") { delta.rotationAngle = std::stof(value); delta.fields |= EntityDelta::ROTATION; }
+        else if (key == "texturePath") { delta.texturePath = value; delta.fields |= EntityDelta::TEXTURE_PATH; }
+        else if (key == "cr") { delta.color.r = static_cast<uint8_t>(std::stoi(value)); delta.fields |= EntityDelta::COLOR; }
+        else if (key == "cg") { delta.color.g = static_cast<uint8_t>(std::stoi(value)); delta.fields |= EntityDelta::COLOR; }
+        else if (key == "cb") { delta.color.b = static_cast<uint8_t>(std::stoi(value)); delta.fields |= EntityDelta::COLOR; }
+        else if (key == "ca") { delta.color.a = static_cast<uint8_t>(std::stoi(value)); delta.fields |= EntityDelta::COLOR; }
     }
-
-    entity->setOriginalSize(entity->getSize());
-    entity->setOriginalPosition(entity->getPosition());
-    return entity;
 }
 
+// Decodes an entity_update message into deltas in one pass, without building a JSON tree. The deltas
+// are reused between snapshots, so decoding a snapshot does not allocate once they are warm.
+class SnapshotDecoder final : public nlohmann::json_sax<json> {
+public:
+    SnapshotDecoder(std::vector<EntityDelta>& deltas, int clientId) : _deltas(deltas), _clientId(clientId) {}
+
+    size_t count = 0;                                        // Deltas decoded into the front of the vector
+    bool isEntityUpdate = false;
+    bool hasServerTime = false;
+    int64_t serverTime = 0;
+    bool hasAck = false;                                     // The snapshot acknowledged an input of this client
+    uint32_t ack = 0;
+
+    bool null() override { return true; }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t value) override {
+        if (_depth == 1 && _key == Key::SERVER_TIME) {
+            serverTime = value;
+            hasServerTime = true;
+        }
+        else if (_depth == 3 && _inAcks) {
+            // Acknowledgements are [clientId, sequence] pairs
+            if (_ackField == 0) _ackClient = value;
+            else if (_ackField == 1 && _ackClient == _clientId) {
+                ack = static_cast<uint32_t>(value);
+                hasAck = true;
+            }
+            _ackField++;
+            return true;
+        }
+        return number(static_cast<double>(value));
+    }
+    bool number_unsigned(number_unsigned_t value) override { return number_integer(static_cast<number_integer_t>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return number(value); }
+    bool binary(binary_t&) override { return true; }
+
+    bool string(string_t& value) override {
+        if (_depth == 1 && _key == Key::TYPE) isEntityUpdate = value == "entity_update";
+        if (!_current || _depth != 3) return true;
+
+        switch (_key) {
+        case Key::ENTITY_TYPE: _current->entityType = stringToEntityType(value); _current->fields |= EntityDelta::ENTITY_TYPE; break;
+        case Key::ZONE_TYPE: _current->zoneType = stringToZoneType(value); _current->fields |= EntityDelta::ZONE_TYPE; break;
+        case Key::TEXTURE_PATH: _current->texturePath.assign(value); _current->fields |= EntityDelta::TEXTURE_PATH; break;
+        default: break;
+        }
+        return true;
+    }
+
+    bool key(string_t& value) override {
+        _key = Key::NONE;
+        if (_depth == 1) {
+            if (value == "type") _key = Key::TYPE;
+            else if (value == "serverTime") _key = Key::SERVER_TIME;
+            else if (value == "entities") _key = Key::ENTITIES;
+            else if (value == "acks") _key = Key::ACKS;
+        }
+        else if (_depth == 3 && _current) {
+            static const std::pair<const char*, Key> keys[] = {
+                { "id", Key::ID }, { "x", Key::X }, { "y", Key::Y }, { "width", Key::WIDTH }, { "height", Key::HEIGHT },
+                { "type", Key::ENTITY_TYPE }, { "zoneType", Key::ZONE_TYPE }, { "velocityX", Key::VELOCITY_X },
+                { "velocityY", Key::VELOCITY_Y }, { "accelerationX", Key::ACCELERATION_X }, { "accelerationY", Key::ACCELERATION_Y },
+                { "rotationAngle", Key::ROTATION }, { "texturePath", Key::TEXTURE_PATH },
+                { "cr", Key::CR }, { "cg", Key::CG }, { "cb", Key::CB }, { "ca", Key::CA },
+            };
+            for (const auto& [name, key] : keys) {
+                if (value == name) {
+                    _key = key;
+                    break;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        _depth++;
+        if (_depth == 3 && _inEntities) {
+            if (count == _deltas.size()) _deltas.emplace_back();
+            _current = &_deltas[count];
+            _current->reset();
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (_depth == 3 && _current) {
+            if (_current->id >= 0) count++;
+            _current = nullptr;
+        }
+        _depth--;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        _depth++;
+        if (_depth == 2 && _key == Key::ENTITIES) _inEntities = true;
+        if (_depth == 2 && _key == Key::ACKS) _inAcks = true;
+        if (_depth == 3 && _inAcks) _ackField = 0;
+        return true;
+    }
+
+    bool end_array() override {
+        if (_depth == 2) {
+            _inEntities = false;
+            _inAcks = false;
+        }
+        _depth--;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override { return false; }
+
+private:
+    enum class Key {
+        NONE, TYPE, SERVER_TIME, ENTITIES, ACKS,
+        ID, X, Y, WIDTH, HEIGHT, ENTITY_TYPE, ZONE_TYPE, VELOCITY_X, VELOCITY_Y,
+        ACCELERATION_X, ACCELERATION_Y, ROTATION, TEXTURE_PATH, CR, CG, CB, CA
+    };
+
+    std::vector<EntityDelta>& _deltas;
+    int _clientId;
+    EntityDelta* _current = nullptr;
+    int _depth = 0;
+    bool _inEntities = false;
+    bool _inAcks = false;
+    int _ackField = 0;
+    int64_t _ackClient = -1;
+    Key _key = Key::NONE;
+
+    bool number(double value) {
+        if (!_current || _depth != 3) return true;
+
+        EntityDelta& delta = *_current;
+        float number = static_cast<float>(value);
+        uint8_t channel = static_cast<uint8_t>(value);
+        switch (_key) {
+        case Key::ID: delta.id = static_cast<int>(value); break;
+        case Key::X: delta.position.x = number; delta.fields |= EntityDelta::POSITION; break;
+        case Key::Y: delta.position.y = number; delta.fields |= EntityDelta::POSITION; break;
+        case Key::WIDTH: delta.size.width = number; delta.fields |= EntityDelta::SIZE; break;
+        case Key::HEIGHT: delta.size.height = number; delta.fields |= EntityDelta::SIZE; break;
+        case Key::VELOCITY_X: delta.velocity.x = number; delta.fields |= EntityDelta::VELOCITY; break;
+        case Key::VELOCITY_Y: delta.velocity.y = number; delta.fields |= EntityDelta::VELOCITY; break;
+        case Key::ACCELERATION_X: delta.acceleration.x = number; delta.fields |= EntityDelta::ACCELERATION; break;
+        case Key::ACCELERATION_Y: delta.acceleration.y = number; delta.fields |= EntityDelta::ACCELERATION; break;
+        case Key::ROTATION: delta.rotationAngle = number; delta.fields |= EntityDelta::ROTATION; break;
+        case Key::CR: delta.color.r = channel; delta.fields |= EntityDelta::COLOR; break;
+        case Key::CG: delta.color.g = channel; delta.fields |= EntityDelta::COLOR; break;
+        case Key::CB: delta.color.b = channel; delta.fields |= EntityDelta::COLOR; break;
+        case Key::CA: delta.color.a = channel; delta.fields |= EntityDelta::COLOR; break;
+        default: break;
+        }
+        return true;
+    }
+};
+
 constexpr bool useJSON = true;
 
 // Receives entity updates from the server
 void Client::receiveEntityUpdatesFromServer(EventManager* eventManager) {
-    zmq::message_t update;
-
+    PROFILE_ZONE("Client::receiveEntityUpdatesFromServer");
     if (_gameState == GameState::PAUSED) return;
 
-    if (_entitySubscriber.recv(update, zmq::recv_flags::dontwait)) {
-        std::string allEntityUpdates(static_cast<char*>(update.data()), update.size());
+    // The message is decoded where ZMQ received it
+    if (_entitySubscriber.recv(_entityUpdateMessage, zmq::recv_flags::dontwait)) {
+        _bytesReceived += _entityUpdateMessage.size();
+        size_t topicSize = _entityTopic.size();
+
+        // Snapshots that the server shares between clients come as a topic frame followed by the body.
+        // The frames of a message arrive together, so the body is already there.
+        if (_entityUpdateMessage.more()) {
+            if (!_entitySubscriber.recv(_entityUpdateMessage, zmq::recv_flags::dontwait)) return;
+            _bytesReceived += _entityUpdateMessage.size();
+            topicSize = 0;
+        }
+
+        const char* data = static_cast<const char*>(_entityUpdateMessage.data());
+        applyEntityUpdates(data + topicSize, _entityUpdateMessage.size() - topicSize, eventManager);
+    }
+}
 
-        if (useJSON) {
-            json entityUpdates = json::parse(allEntityUpdates);
+void Client::applyEntityUpdates(const std::string& allEntityUpdates, EventManager* eventManager) {
+    applyEntityUpdates(allEntityUpdates.data(), allEntityUpdates.size(), eventManager);
+}
 
-            if (entityUpdates["type"] != "entity_update") {
-                printf("Invalid entity update message.\n");
-                return;
-            }
+// Decodes an entity update message straight into the entities it updates
+void Client::applyEntityUpdates(const char* data, size_t size, EventManager* eventManager) {
+    PROFILE_ZONE("Client::applyEntityUpdates");
+    if (useJSON) {
+        SnapshotDecoder decoder(_deltas, _clientID);
+        if (!json::sax_parse(data, data + size, &decoder) || !decoder.isEntityUpdate) {
+            printf("Invalid entity update message.\n");
+            return;
+        }
 
-            for (const auto& updatedJSONEntity : entityUpdates["entities"]) {
-                Entity* updatedEntity = jsonToEntity(updatedJSONEntity);
-                Event* entityUpdateEvent = new EntityUpdateEvent(updatedEntity);
-                eventManager->raiseEvent(entityUpdateEvent);
-            }
-        } else {
-            auto parts = split(allEntityUpdates, "|||");
-            if (parts.size() != 2 || parts[0] != "entity_update") {
-                throw std::runtime_error("Invalid data format");
+        _snapshotCount++;
+        _snapshotLatencyUs = decoder.hasServerTime ? Server::wallClockUs() - decoder.serverTime : -1;
+
+        // Sequence numbers only grow, and acknowledgements of inputs that are out of the history are dropped
+        if (decoder.hasAck && decoder.ack > _lastAckedInput && decoder.ack <= _inputSequence) {
+            _lastAckedInput = decoder.ack;
+            if (_inputSequence - decoder.ack < INPUT_HISTORY) {
+                _inputRttUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - _inputSendTimes[decoder.ack % INPUT_HISTORY]).count();
+                _inputAckCount++;
             }
+        }
+        applyDeltas(decoder.count, eventManager);
+    } else {
+        auto parts = split(std::string(data, size), "|||");
+        if (parts.size() != 2 || parts[0] != "entity_update") {
+            throw std::runtime_error("Invalid data format");
+        }
 
-            // Split the entity data by "||"
-            auto entityStrings = split(parts[1], "||");
-            std::vector<Entity> entities;
+        // Split the entity data by "||"
+        auto entityStrings = split(parts[1], "||");
+        if (_deltas.size() < entityStrings.size()) _deltas.resize(entityStrings.size());
+        for (size_t i = 0; i < entityStrings.size(); i++) {
+            stringToDelta(entityStrings[i], _deltas[i]);
+        }
+        applyDeltas(entityStrings.size(), eventManager);
+    }
+}
 
-            for (const auto& entityString : entityStrings) {
-                const auto* updatedEntity = stringToEntity(entityString);
+// Writes the changed fields of the first 'count' decoded deltas into their entities, and raises an
+// EntityUpdateEvent for each changed entity if update events are enabled
+void Client::applyDeltas(size_t count, EventManager* eventManager) {
+    bool raiseEvents = _updateEvents && eventManager;
 
-                for (Entity*& entity : _entities) {
-                    if (entity->getZoneType() == ZoneType::SIDESCROLL) continue;
-                    if (_gameState == GameState::PAUSED && entity->getEntityID() == _entityID) {
-                        continue;
-                    }
+    for (size_t i = 0; i < count; i++) {
+        EntityDelta& delta = _deltas[i];
+        Entity* entity = findEntity(delta.id);
+        if (!entity || entity->getZoneType() == ZoneType::SIDESCROLL) continue;
+        if (_gameState == GameState::PAUSED && delta.id == _entityID) continue;
 
-                    if (entity->getEntityID() == updatedEntity->getEntityID()) {
-                        *entity = *updatedEntity;
-                        break;
-                    }
-                }
+        uint32_t decoded = delta.fields;
+        if (delta.diff(*entity) != 0 && _applyUpdates) delta.applyTo(*entity);
 
-                delete updatedEntity;
-            }
+        if (raiseEvents) {
+            if (_fullUpdateEvents) delta.fields = decoded;
+            if (delta.fields != 0) eventManager->raiseEvent(new EntityUpdateEvent(delta));
         }
     }
+    if (raiseEvents) _fullUpdateEvents = false;
+}
+
+// Looks an entity up by ID. The index is rebuilt when entities were added or removed, or when an indexed
+// entity was destroyed behind its back.
+Entity* Client::findEntity(int entityId) {
+    if (_indexedCount != _entities.size()) indexEntities();
+    auto it = _entityIndex.find(entityId);
+    if (it == _entityIndex.end()) return nullptr;
+
+    Entity* entity = EntityRegistry::getInstance().get(it->second);
+    if (!entity) {
+        indexEntities();
+        it = _entityIndex.find(entityId);
+        entity = it != _entityIndex.end() ? EntityRegistry::getInstance().get(it->second) : nullptr;
+    }
+    return entity;
+}
+
+void Client::indexEntities() {
+    _entityIndex.clear();
+    for (Entity* entity : _entities) {
+        _entityIndex.emplace(entity->getEntityID(), entity->getHandle());
+    }
+    _indexedCount = _entities.size();
 }
 
 // Receives all other messages from the server apart from entity updates
 void Client::receiveMessagesFromServer() {
-    zmq::message_t update;
-
-    if (_subscriber.recv(update, zmq::recv_flags::dontwait)) {
-        std::string message(static_cast<char*>(update.data()), update.size());
-        json jsonMessage = json::parse(message);
+    PROFILE_ZONE("Client::receiveMessagesFromServer");
+    if (_subscriber.recv(_message, zmq::recv_flags::dontwait)) {
+        _bytesReceived += _message.size();
+        const char* message = static_cast<const char*>(_message.data());
+        json jsonMessage = json::parse(message + _topic.size(), message + _message.size());
 
         // Handles client disconnect message
         if (jsonMessage["type"] == "disconnect") {
@@ -296,9 +627,10 @@ void Client::receiveMessagesFromServer() {
             // Iterate through _entities and remove the one with the matching entityID
             for (auto it = _entities.begin(); it != _entities.end(); ++it) {
                 if ((*it)->getEntityID() == entityID) {
-                    delete* it;  
+                    delete *it;
                     _entities.erase(it);  
-                    printf("A player disconnected. Their player entity was removed.\n");
+                    indexEntities();
+                    if (_verbose) printf("A player disconnected. Their player entity was removed.\n");
                     break;  
                 }
             }
@@ -311,9 +643,32 @@ void Client::receiveMessagesFromServer() {
             Entity* newEntity = deserializeEntity(serializedEntity);
             if (newEntity && newEntity->getEntityID() != _entityID) {
                 _entities.push_back(newEntity);
-                printf("A new player has connected. Their player entity ID: %d\n", newEntity->getEntityID());
+                indexEntities();
+                if (_verbose) printf("A new player has connected. Their player entity ID: %d\n", newEntity->getEntityID());
             }
         }
+        // Handles static entities that were modified or added on the server
+        else if (jsonMessage["type"] == "static_update") {
+            for (const auto& serializedEntity : jsonMessage["entities"]) {
+                Entity* update = deserializeEntity(serializedEntity.get<std::string>());
+                if (!update) continue;
+                update->setStatic(hasStaticType(*update));
+
+                Entity* entity = findEntity(update->getEntityID());
+                if (!entity) {
+                    _entities.push_back(update);
+                    indexEntities();
+                    continue;
+                }
+
+                EntityDelta delta;
+                delta.capture(*update);
+                if (delta.diff(*entity) != 0) delta.applyTo(*entity);
+                entity->setStatic(update->isStatic());
+                delete update;
+            }
+            _staticRevision++;
+        }
     }
 }
 
@@ -354,3 +709,31 @@ void Client::setViewOffset(Position viewOffset) {
     _viewOffset = viewOffset;
 }
 
+void Client::setRoomID(int roomId) {
+    _roomID = roomId;
+    _topic = roomId < 0 ? "" : ServerHost::roomTopic(roomId);
+}
+
+void Client::setHeartbeatInterval(int milliseconds) {
+    _heartbeatInterval = std::chrono::milliseconds(milliseconds);
+}
+
+void Client::setServerHost(const std::string& host) { _serverHost = host; }
+void Client::setVerbose(bool verbose) { _verbose = verbose; }
+void Client::setWorldCacheDirectory(const std::string& directory) { _worldCacheDirectory = directory; }
+void Client::setApplyUpdates(bool apply) { _applyUpdates = apply; }
+void Client::setBandwidth(int64_t bytesPerSecond) { _bandwidth = bytesPerSecond; }
+
+void Client::setUpdateEventsEnabled(bool enabled) {
+    if (enabled && !_updateEvents) _fullUpdateEvents = true;
+    _updateEvents = enabled;
+}
+
+uint64_t Client::getSnapshotCount() const { return _snapshotCount; }
+uint64_t Client::getBytesReceived() const { return _bytesReceived; }
+uint64_t Client::getBytesSent() const { return _bytesSent.load(std::memory_order_relaxed); }
+int64_t Client::getSnapshotLatencyUs() const { return _snapshotLatencyUs; }
+int64_t Client::getInputRttUs() const { return _inputRttUs; }
+uint64_t Client::getInputAckCount() const { return _inputAckCount; }
+uint64_t Client::getStaticRevision() const { return _staticRevision; }
+
@@ -3,7 +3,11 @@
 #include <EventManager.h>
 
 #include "Entity.h"
+#include "EntityDelta.h"
 #include "Globals.h"
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
 #include <vector>
 #ifdef __APPLE__
 #include <zmq.hpp>
@@ -18,6 +22,8 @@ using json = nlohmann::json;
 class Client {
 public:
     Client();
+    // Creates the client's sockets in a context shared with other clients (e.g. a bot swarm)
+    explicit Client(zmq::context_t& context);
     ~Client();
 
     void initialize(int pubPort = 5556, int entitySubPort = 5555, int reqPort = 5557, int hbPubPort = 5558, int subPort = 5559);
@@ -25,9 +31,14 @@ public:
     void sendHeartbeatToServer();
     void sendInputToServer(const std::string& buttonPress);
     void receiveEntityUpdatesFromServer(EventManager *eventManager);
+    // Decodes an entity update message received from the server and writes the changed fields into the entities
+    void applyEntityUpdates(const std::string& allEntityUpdates, EventManager* eventManager);
+    void applyEntityUpdates(const char* data, size_t size, EventManager* eventManager);
     void receiveMessagesFromServer();
 
     static Entity* deserializeEntity(const std::string& json);
+    // Entity with the given ID, or nullptr
+    Entity* findEntity(int entityId);
 
     void setClientID(int id);
     int getClientID();
@@ -40,9 +51,42 @@ public:
     RefreshRate getRefreshRate() const;
     int getRefreshRateMs() const;
     void setViewOffset(Position viewOffset);
+    void setHeartbeatInterval(int milliseconds);
+    // Joins the given room of a ServerHost instead of a single-world Server. Call before initialize.
+    void setRoomID(int roomId);
+    // Host of the server to connect to. Call before initialize.
+    void setServerHost(const std::string& host);
+    // Disables the per-message console output, e.g. for headless clients
+    void setVerbose(bool verbose);
+    // Keeps the static world of each server on disk, so that reconnecting after a restart skips its download.
+    // The world is always cached in memory for the other clients of the process.
+    void setWorldCacheDirectory(const std::string& directory);
+    // Snapshot bandwidth to ask the server for, in bytes per second (0 for the server's default). Call before the handshake.
+    void setBandwidth(int64_t bytesPerSecond);
+    // Snapshots are still decoded but not applied while false, e.g. while a replay is running
+    void setApplyUpdates(bool apply);
+    // Raises an EntityUpdateEvent with the changed fields of every entity a snapshot updates. The first
+    // snapshot after enabling carries all fields, so the events can rebuild the state on their own.
+    void setUpdateEventsEnabled(bool enabled);
+
+    // Traffic counters, cumulative since construction
+    uint64_t getSnapshotCount() const;
+    uint64_t getBytesReceived() const;
+    uint64_t getBytesSent() const;
+    // Age of the latest snapshot when it was decoded (server timestamp to now), or -1 if it carried none
+    int64_t getSnapshotLatencyUs() const;
+    // Round trip of the latest acknowledged input, from sending it to the first snapshot that acknowledged it,
+    // measured on the client's own clock (-1 until one was acknowledged). Inputs that were acknowledged
+    // together count once, for the newest of them.
+    int64_t getInputRttUs() const;
+    // Number of input round trips measured so far
+    uint64_t getInputAckCount() const;
+    // Changes whenever static entities were received or updated. Static entities are not part of snapshots,
+    // so the engine only rescales them when this changes.
+    uint64_t getStaticRevision() const;
 
 private:
-    zmq::context_t _context;
+    zmq::context_t _context;                                 // Unused when the context is shared
     zmq::socket_t _publisher;
     zmq::socket_t _heartbeatPublisher;
     zmq::socket_t _entitySubscriber;
@@ -50,6 +94,16 @@ private:
     zmq::socket_t _requester;
 
     std::vector<Entity*> _entities;    
+    std::unordered_map<int, EntityHandle> _entityIndex;      // Entity ID to entity, for applying snapshots
+    size_t _indexedCount = 0;                                // Size of _entities when the index was built
+    std::vector<EntityDelta> _deltas;                        // Decoded snapshot, reused between snapshots
+    bool _applyUpdates = true;
+    bool _updateEvents = false;
+    bool _fullUpdateEvents = false;                          // Next events carry every field
+
+    // Receive buffers, reused for every message
+    zmq::message_t _entityUpdateMessage;
+    zmq::message_t _message;
 
     int _clientID;
     int _entityID;
@@ -59,4 +113,38 @@ private:
     int _refreshRateMs;
 
     GameState _gameState;
+
+    int _roomID = -1;                                        // Room to join on a ServerHost (-1 for a plain Server)
+    std::string _topic;                                      // Topic prefix of messages published to this client's room
+    std::string _entityTopic;                                // Topic prefix of this client's snapshots
+    std::string _serverHost = "localhost";
+    bool _verbose = true;
+    std::string _worldCacheDirectory;
+    int64_t _bandwidth = 0;
+
+    uint64_t _snapshotCount = 0;
+    uint64_t _bytesReceived = 0;
+    std::atomic<uint64_t> _bytesSent{ 0 };
+    int64_t _snapshotLatencyUs = -1;
+
+    // Inputs carry a sequence number that the server echoes in a later snapshot. Sent on the thread that decodes snapshots.
+    static constexpr uint32_t INPUT_HISTORY = 64;            // Send times kept for inputs that are still unacknowledged
+    uint32_t _inputSequence = 0;
+    uint32_t _lastAckedInput = 0;
+    std::chrono::steady_clock::time_point _inputSendTimes[INPUT_HISTORY];
+    int64_t _inputRttUs = -1;
+    uint64_t _inputAckCount = 0;
+    std::atomic<uint64_t> _staticRevision{ 0 };
+
+    void createSockets(zmq::context_t& context);
+    void applyDeltas(size_t count, EventManager* eventManager);
+    void indexEntities();
+    std::string worldCacheKey() const;
+    std::string loadCachedWorld();
+    void storeCachedWorld(const std::string& blob);
+
+    // Heartbeats are only sent when no other message went out within this interval
+    std::chrono::milliseconds _heartbeatInterval = std::chrono::milliseconds(250);
+    std::atomic<int64_t> _lastSendTime{ 0 };                 // Time of the last message sent to the server (ns)
+    void markSent(size_t bytes);
 };
@@ -0,0 +1,55 @@
+#include "MessagePool.h"
+
+MessagePool& MessagePool::getInstance() {
+    static MessagePool* instance = new MessagePool();
+    return *instance;
+}
+
+std::string* MessagePool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free.empty()) {
+            std::string* buffer = _free.back();
+            _free.pop_back();
+            return buffer;
+        }
+    }
+    _allocated.fetch_add(1, std::memory_order_relaxed);
+    return new std::string();
+}
+
+void MessagePool::release(std::string* buffer) {
+    buffer->clear();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_free.size() < MAX_POOLED) {
+            _free.push_back(buffer);
+            return;
+        }
+    }
+    delete buffer;
+}
+
+// Called by ZMQ once the message has been sent
+void MessagePool::free(void*, void* hint) {
+    getInstance().release(static_cast<std::string*>(hint));
+}
+
+zmq::message_t MessagePool::wrap(std::string& text) {
+    std::string* buffer = acquire();
+    buffer->swap(text);
+    return zmq::message_t(&(*buffer)[0], buffer->size(), &MessagePool::free, buffer);
+}
+
+zmq::message_t MessagePool::wrap(const std::string& topic, std::string& text) {
+    std::string* buffer = acquire();
+    buffer->reserve(topic.size() + text.size());
+    buffer->append(topic);
+    buffer->append(text);
+    text.clear();
+    return zmq::message_t(&(*buffer)[0], buffer->size(), &MessagePool::free, buffer);
+}
+
+size_t MessagePool::getAllocatedCount() const {
+    return _allocated.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifdef __APPLE__
+#include <zmq.hpp>
+#else
+#include <ZMQ/zmq.hpp>
+#endif
+
+// Pool of byte buffers that are handed to ZMQ without copying. A message owns its buffer until ZMQ has
+// sent it, then ZMQ's free callback returns the buffer to the pool (possibly from an I/O thread).
+//
+// Senders serialize into a std::string they keep between sends and call wrap(): the contents are swapped
+// into a pooled buffer, and the sender gets an empty recycled buffer back with its capacity intact. Once
+// the pool is warm, sending makes no heap allocations and no copies.
+class MessagePool {
+public:
+    // The pool is never destroyed, since ZMQ may release messages while the process exits
+    static MessagePool& getInstance();
+
+    MessagePool(const MessagePool&) = delete;
+    void operator=(const MessagePool&) = delete;
+
+    // Moves the contents of 'text' into a message. 'text' is left empty.
+    zmq::message_t wrap(std::string& text);
+    // Moves the topic and the contents of 'text' into one message. 'text' is left empty.
+    zmq::message_t wrap(const std::string& topic, std::string& text);
+
+    // Number of buffers allocated so far. Stays constant in steady state.
+    size_t getAllocatedCount() const;
+
+private:
+    MessagePool() = default;
+
+    std::string* acquire();
+    void release(std::string* buffer);
+    static void free(void* data, void* hint);
+
+    static constexpr size_t MAX_POOLED = 256;             // Buffers kept for reuse; the rest are freed
+
+    std::mutex _mutex;
+    std::vector<std::string*> _free;
+    std::atomic<size_t> _allocated{ 0 };
+};
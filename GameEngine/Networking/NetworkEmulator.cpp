@@ -0,0 +1,254 @@
+#include "NetworkEmulator.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+static const int64_t RETRANSMIT_DELAY_NS = 200000000;    // Delay of a lost request or reply
+
+static int64_t steadyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+static int64_t msToNs(int milliseconds) {
+    return static_cast<int64_t>(milliseconds) * 1000000;
+}
+
+bool LinkConditions::parse(const std::string& spec, LinkConditions& conditions) {
+    conditions = LinkConditions();
+    if (spec.empty() || spec == "-") return true;
+
+    std::stringstream stream(spec);
+    std::string pair;
+    try {
+        while (std::getline(stream, pair, ',')) {
+            size_t separator = pair.find('=');
+            if (separator == std::string::npos) return false;
+            std::string key = pair.substr(0, separator);
+            std::string value = pair.substr(separator + 1);
+
+            if (key == "delay") conditions.delayMs = std::stoi(value);
+            else if (key == "jitter") conditions.jitterMs = std::stoi(value);
+            else if (key == "loss") conditions.lossRate = std::stod(value);
+            else if (key == "reorder") conditions.reorderRate = std::stod(value);
+            else if (key == "reorderDelay") conditions.reorderDelayMs = std::stoi(value);
+            else if (key == "bandwidth") conditions.bandwidthBytesPerSecond = std::stoll(value);
+            else if (key == "queue") conditions.queueLimit = static_cast<size_t>(std::stoul(value));
+            else return false;
+        }
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+std::string LinkConditions::toString() const {
+    std::ostringstream oss;
+    oss << "delay=" << delayMs << "ms jitter=" << jitterMs << "ms loss=" << lossRate * 100 << "% reorder=" << reorderRate * 100 << "%";
+    if (bandwidthBytesPerSecond > 0) oss << " bandwidth=" << bandwidthBytesPerSecond / 1024.0 << "KB/s";
+    return oss.str();
+}
+
+NetworkEmulator::NetworkEmulator(zmq::context_t& context, unsigned seed) : _context(context), _random(seed) {}
+
+NetworkEmulator::~NetworkEmulator() {
+    stop();
+}
+
+void NetworkEmulator::addChannel(EmulatedChannel type, int listenPort, const std::string& targetAddress) {
+    auto channel = std::make_unique<Channel>();
+    channel->type = type;
+
+    switch (type) {
+    case EmulatedChannel::Subscription:
+        // Subscriptions travel upstream, so the link only carries the topics its clients subscribed to
+        channel->clientSide = zmq::socket_t(_context, zmq::socket_type::xpub);
+        channel->serverSide = zmq::socket_t(_context, zmq::socket_type::xsub);
+        break;
+    case EmulatedChannel::Publication:
+        channel->clientSide = zmq::socket_t(_context, zmq::socket_type::sub);
+        channel->serverSide = zmq::socket_t(_context, zmq::socket_type::pub);
+        channel->clientSide.set(zmq::sockopt::subscribe, "");
+        break;
+    case EmulatedChannel::Request:
+        channel->clientSide = zmq::socket_t(_context, zmq::socket_type::router);
+        channel->serverSide = zmq::socket_t(_context, zmq::socket_type::dealer);
+        break;
+    }
+
+    channel->clientSide.set(zmq::sockopt::linger, 0);
+    channel->serverSide.set(zmq::sockopt::linger, 0);
+    channel->clientSide.bind("tcp://*:" + std::to_string(listenPort));
+    channel->serverSide.connect(targetAddress);
+    _channels.push_back(std::move(channel));
+}
+
+void NetworkEmulator::addServerChannels(int listenBasePort, const std::string& serverHost, int serverBasePort) {
+    std::string address = "tcp://" + serverHost + ":";
+    addChannel(EmulatedChannel::Subscription, listenBasePort, address + std::to_string(serverBasePort));
+    addChannel(EmulatedChannel::Publication, listenBasePort + 1, address + std::to_string(serverBasePort + 1));
+    addChannel(EmulatedChannel::Request, listenBasePort + 2, address + std::to_string(serverBasePort + 2));
+    addChannel(EmulatedChannel::Publication, listenBasePort + 3, address + std::to_string(serverBasePort + 3));
+    addChannel(EmulatedChannel::Subscription, listenBasePort + 4, address + std::to_string(serverBasePort + 4));
+}
+
+void NetworkEmulator::setConditions(Direction direction, const LinkConditions& conditions) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _links[static_cast<int>(direction)].conditions = conditions;
+}
+
+LinkConditions NetworkEmulator::getConditions(Direction direction) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _links[static_cast<int>(direction)].conditions;
+}
+
+NetworkEmulator::LinkStats NetworkEmulator::getStats(Direction direction) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _links[static_cast<int>(direction)].stats;
+}
+
+void NetworkEmulator::start() {
+    if (_running.exchange(true)) return;
+    _thread = std::thread(&NetworkEmulator::run, this);
+}
+
+void NetworkEmulator::stop() {
+    if (!_running.exchange(false)) return;
+    _thread.join();
+}
+
+// Receives all frames of one message. Returns false if no message is waiting.
+bool NetworkEmulator::receiveFrames(zmq::socket_t& socket, std::vector<zmq::message_t>& frames) {
+    frames.clear();
+    zmq::message_t frame;
+    if (!socket.recv(frame, zmq::recv_flags::dontwait)) return false;
+
+    bool more = frame.more();
+    frames.push_back(std::move(frame));
+    while (more) {
+        zmq::message_t next;
+        (void)socket.recv(next, zmq::recv_flags::none);
+        more = next.more();
+        frames.push_back(std::move(next));
+    }
+    return true;
+}
+
+// Decides if and when the message comes out of the other end of the link
+void NetworkEmulator::enqueue(size_t channel, Direction direction, std::vector<zmq::message_t>&& frames) {
+    size_t bytes = 0;
+    for (const zmq::message_t& frame : frames) bytes += frame.size();
+
+    // Requests and subscriptions are never dropped, only delayed
+    EmulatedChannel type = _channels[channel]->type;
+    bool reliable = type == EmulatedChannel::Request || (type == EmulatedChannel::Subscription && direction == Direction::Upstream);
+    int64_t now = steadyNow();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Link& link = _links[static_cast<int>(direction)];
+    const LinkConditions& conditions = link.conditions;
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    int64_t extraDelay = 0;
+    if (conditions.lossRate > 0 && chance(_random) < conditions.lossRate) {
+        if (!reliable) {
+            link.stats.dropped++;
+            return;
+        }
+        extraDelay += RETRANSMIT_DELAY_NS;
+    }
+    if (!reliable && conditions.queueLimit > 0 && link.queued >= conditions.queueLimit) {
+        link.stats.dropped++;
+        return;
+    }
+
+    // The link sends one message at a time at the configured rate, so a backlog turns into delay
+    int64_t departure = now;
+    if (conditions.bandwidthBytesPerSecond > 0) {
+        departure = std::max(now, link.freeAt) + static_cast<int64_t>(bytes * 1e9 / conditions.bandwidthBytesPerSecond);
+        link.freeAt = departure;
+    }
+
+    int64_t deliveryAt = departure + msToNs(conditions.delayMs) + extraDelay;
+    if (conditions.jitterMs > 0) {
+        deliveryAt += std::uniform_int_distribution<int64_t>(0, msToNs(conditions.jitterMs))(_random);
+    }
+
+    if (conditions.reorderRate > 0 && chance(_random) < conditions.reorderRate) {
+        deliveryAt += msToNs(conditions.reorderDelayMs);
+        link.stats.reordered++;
+    }
+    else {
+        // Jitter alone does not reorder a stream
+        deliveryAt = std::max(deliveryAt, link.lastDeliveryAt);
+        link.lastDeliveryAt = deliveryAt;
+    }
+
+    link.queued++;
+    _pending.emplace(std::make_pair(deliveryAt, _sequence++), Pending{ channel, direction, std::move(frames), bytes });
+}
+
+// Sends every message whose delivery time has come
+void NetworkEmulator::deliverDue(int64_t now) {
+    while (!_pending.empty() && _pending.begin()->first.first <= now) {
+        Pending pending = std::move(_pending.begin()->second);
+        _pending.erase(_pending.begin());
+
+        Channel& channel = *_channels[pending.channel];
+        zmq::socket_t& socket = pending.direction == Direction::Upstream ? channel.serverSide : channel.clientSide;
+
+        for (size_t i = 0; i < pending.frames.size(); i++) {
+            auto flags = i + 1 < pending.frames.size() ? zmq::send_flags::sndmore : zmq::send_flags::none;
+            (void)socket.send(pending.frames[i], flags | zmq::send_flags::dontwait);
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        Link& link = _links[static_cast<int>(pending.direction)];
+        link.queued--;
+        link.stats.delivered++;
+        link.stats.bytes += pending.bytes;
+    }
+}
+
+void NetworkEmulator::run() {
+    PROFILE_THREAD("Network emulator");
+
+    // Every socket that messages arrive on, with the channel and direction it feeds
+    std::vector<zmq::pollitem_t> items;
+    std::vector<std::pair<size_t, Direction>> sources;
+    for (size_t i = 0; i < _channels.size(); i++) {
+        Channel& channel = *_channels[i];
+        items.push_back({ channel.clientSide.handle(), 0, ZMQ_POLLIN, 0 });
+        sources.emplace_back(i, Direction::Upstream);
+        if (channel.type != EmulatedChannel::Publication) {
+            items.push_back({ channel.serverSide.handle(), 0, ZMQ_POLLIN, 0 });
+            sources.emplace_back(i, Direction::Downstream);
+        }
+    }
+
+    std::vector<zmq::message_t> frames;
+    while (_running.load(std::memory_order_relaxed)) {
+        // Wakes up for the next delivery, and regularly to notice stop()
+        int64_t timeoutMs = 10;
+        if (!_pending.empty()) {
+            timeoutMs = std::max<int64_t>(0, std::min<int64_t>((_pending.begin()->first.first - steadyNow()) / 1000000, timeoutMs));
+        }
+        zmq::poll(items.data(), items.size(), std::chrono::milliseconds(timeoutMs));
+
+        for (size_t i = 0; i < items.size(); i++) {
+            if (!(items[i].revents & ZMQ_POLLIN)) continue;
+
+            Channel& channel = *_channels[sources[i].first];
+            zmq::socket_t& socket = sources[i].second == Direction::Upstream ? channel.clientSide : channel.serverSide;
+            while (receiveFrames(socket, frames)) {
+                enqueue(sources[i].first, sources[i].second, std::move(frames));
+            }
+        }
+
+        deliverDue(steadyNow());
+    }
+}
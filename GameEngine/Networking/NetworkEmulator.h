@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#ifdef __APPLE__
+#include <zmq.hpp>
+#else
+#include <ZMQ/zmq.hpp>
+#endif
+
+// Conditions of one direction of an emulated link
+struct LinkConditions {
+    int delayMs = 0;                                      // One-way delay
+    int jitterMs = 0;                                     // Uniform extra delay in [0, jitter]
+    double lossRate = 0;                                  // Fraction of messages dropped
+    double reorderRate = 0;                               // Fraction of messages held back so that later ones overtake them
+    int reorderDelayMs = 20;                              // How long a reordered message is held back
+    int64_t bandwidthBytesPerSecond = 0;                  // 0 for unlimited
+    size_t queueLimit = 1000;                             // Messages queued on the link before new ones are dropped, like a ZMQ high water mark
+
+    // Parses "delay=50,jitter=10,loss=0.02,reorder=0.01,reorderDelay=30,bandwidth=64000,queue=1000".
+    // An empty spec or "-" is a perfect link. Returns false on unknown keys or malformed values.
+    static bool parse(const std::string& spec, LinkConditions& conditions);
+    std::string toString() const;
+};
+
+// How an emulated channel is wired. The emulator binds the client-facing port and connects to the target.
+enum class EmulatedChannel {
+    Subscription,                                         // Target PUB -> clients' SUB (downstream), subscriptions upstream
+    Publication,                                          // Clients' PUB -> target SUB (upstream)
+    Request                                               // Clients' REQ -> target REP (upstream), replies downstream
+};
+
+// Proxy that sits between the engine's ZMQ sockets and injects delay, jitter, loss, reordering and
+// bandwidth limits per direction. All channels of one direction share one link, so traffic competes
+// for its bandwidth. Run one emulator per client to give each client its own link.
+//
+// Requests and replies are never dropped, since a REQ socket would wait forever; a lost request or
+// reply arrives one retransmission timeout late instead, like on a TCP connection.
+class NetworkEmulator {
+public:
+    enum class Direction { Upstream, Downstream };
+
+    struct LinkStats {
+        uint64_t delivered = 0;
+        uint64_t dropped = 0;
+        uint64_t reordered = 0;
+        uint64_t bytes = 0;                               // Delivered bytes
+    };
+
+    // The seed makes loss, jitter and reordering reproducible between runs
+    explicit NetworkEmulator(zmq::context_t& context, unsigned seed = 1);
+    ~NetworkEmulator();
+
+    NetworkEmulator(const NetworkEmulator&) = delete;
+    void operator=(const NetworkEmulator&) = delete;
+
+    // Call before start
+    void addChannel(EmulatedChannel type, int listenPort, const std::string& targetAddress);
+    // Adds the five channels of a Server, listening on listenBasePort + 0..4 in the order of the server's
+    // default ports (entity updates, input, handshake, heartbeats, general messages)
+    void addServerChannels(int listenBasePort, const std::string& serverHost = "localhost", int serverBasePort = 5555);
+
+    // Applies to messages that arrive from now on. Safe to call while running.
+    void setConditions(Direction direction, const LinkConditions& conditions);
+    LinkConditions getConditions(Direction direction);
+    LinkStats getStats(Direction direction);
+
+    void start();
+    void stop();
+
+private:
+    struct Channel {
+        EmulatedChannel type;
+        zmq::socket_t clientSide;                         // Bound on the listen port
+        zmq::socket_t serverSide;                         // Connected to the target
+    };
+
+    struct Pending {
+        size_t channel;
+        Direction direction;
+        std::vector<zmq::message_t> frames;
+        size_t bytes;
+    };
+
+    struct Link {
+        LinkConditions conditions;
+        LinkStats stats;
+        int64_t freeAt = 0;                               // When the link finishes sending the queued messages (ns)
+        int64_t lastDeliveryAt = 0;                       // Keeps delivery in order unless a message is reordered
+        size_t queued = 0;
+    };
+
+    void run();
+    void enqueue(size_t channel, Direction direction, std::vector<zmq::message_t>&& frames);
+    void deliverDue(int64_t now);
+    static bool receiveFrames(zmq::socket_t& socket, std::vector<zmq::message_t>& frames);
+
+    zmq::context_t& _context;
+    std::vector<std::unique_ptr<Channel>> _channels;
+
+    std::mutex _mutex;                                    // Guards the links
+    Link _links[2];
+    std::mt19937 _random;
+
+    std::map<std::pair<int64_t, uint64_t>, Pending> _pending;   // Keyed by (delivery time, arrival order)
+    uint64_t _sequence = 0;
+
+    std::thread _thread;
+    std::atomic<bool> _running{ false };
+};
@@ -1,6 +1,7 @@
 #include "Peer.h"
 
 #include <Client.h>
+#include "MessagePool.h"
 #include <iostream>
 #include <string>
 #ifdef __APPLE__
@@ -149,9 +150,7 @@ void Peer::broadcastUpdates() {
             std::ostringstream messageStream;
             messageStream << "WORLD_UPDATE|" << entity->getEntityID() << "|" << entity->getOriginalPosition().x << "," << entity->getOriginalPosition().y;
             std::string message = messageStream.str();
-            zmq::message_t zmqMessage(message.size());
-            memcpy(zmqMessage.data(), message.c_str(), message.size());
-            _publisher.send(zmqMessage, zmq::send_flags::none);
+            _publisher.send(MessagePool::getInstance().wrap(message), zmq::send_flags::none);
         }
     }
 
@@ -161,9 +160,7 @@ void Peer::broadcastUpdates() {
             std::ostringstream messageStream;
             messageStream << "PEER_UPDATE|" << _peerID << "|" << _entityID << "|" << entity->getOriginalPosition().x << "," << entity->getOriginalPosition().y;
             std::string message = messageStream.str();
-            zmq::message_t zmqMessage(message.size());
-            memcpy(zmqMessage.data(), message.c_str(), message.size());
-            _publisher.send(zmqMessage, zmq::send_flags::none);
+            _publisher.send(MessagePool::getInstance().wrap(message), zmq::send_flags::none);
             break;
         }
     }
@@ -242,8 +239,9 @@ void Peer::receiveUpdates() {
 }
 
 // Returns the entity list that physics should be applied to, for this peer.
-std::vector<Entity*> Peer::getEntitiesToProcess() const {
-    std::vector<Entity*> entitiesToProcess;
+FrameVector<Entity*> Peer::getEntitiesToProcess(FrameArena& arena) const {
+    FrameVector<Entity*> entitiesToProcess{ FrameArena::Allocator<Entity*>(arena) };
+    entitiesToProcess.reserve(1 + (_isHost ? _worldEntities.size() : 0));
 
     // Always process own player entity
     for (auto entity : _playerEntities) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.h"
+#include "FrameArena.h"
 #include <vector>
 #include <map>
 #ifdef __APPLE__
@@ -27,7 +28,8 @@ public:
     int getPlayerEntityID() const;
     std::vector<Entity*> getWorldEntities() const;
     std::vector<Entity*> getPlayerEntities() const;
-    std::vector<Entity*> getEntitiesToProcess() const;
+    // Entities physics should simulate on this peer. The list lives in the arena until its next reset.
+    FrameVector<Entity*> getEntitiesToProcess(FrameArena& arena) const;
 
     void setRefreshRate(RefreshRate rate = RefreshRate::SIXTY_FPS);
     RefreshRate getRefreshRate() const;
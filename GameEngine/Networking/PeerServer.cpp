@@ -1,6 +1,7 @@
 #include "PeerServer.h"
 
 #include <Client.h>
+#include "MessagePool.h"
 #include <iostream>
 #include <Server.h>
 #include <string>
@@ -75,18 +76,20 @@ void PeerServer::run() {
                 }
                 responseStream << "|";
 
-                // Serialize world entities
-                first = true;
-                for (const auto& entity : _worldEntities) {
-                    if (!first) {
-                        responseStream << "\n";
-                    }
-                    else {
-                        first = false;
+                // Serialize world entities. The world does not change, so it is only serialized once.
+                if (_serializedWorld.empty()) {
+                    first = true;
+                    for (const auto& entity : _worldEntities) {
+                        if (!first) {
+                            _serializedWorld += "\n";
+                        }
+                        else {
+                            first = false;
+                        }
+                        _serializedWorld += Server::serializeEntity(*entity);
                     }
-                    responseStream << Server::serializeEntity(*entity);
                 }
-                responseStream << "|";
+                responseStream << _serializedWorld << "|";
 
                 // Serialize all player entities (including assigned one)
                 first = true;
@@ -103,26 +106,20 @@ void PeerServer::run() {
                 std::string response = responseStream.str();
 
                 // Send response to peer
-                zmq::message_t reply(response.size());
-                memcpy(reply.data(), response.c_str(), response.size());
-                _responder.send(reply, zmq::send_flags::none);
+                _responder.send(MessagePool::getInstance().wrap(response), zmq::send_flags::none);
 
                 // Broadcast new peer to existing peers
                 std::ostringstream broadcastStream;
                 broadcastStream << "NEW_PEER|" << peerID << "|" << assignedEntity->getEntityID();
                 std::string broadcastMessage = broadcastStream.str();
-                zmq::message_t broadcast(broadcastMessage.size());
-                memcpy(broadcast.data(), broadcastMessage.c_str(), broadcastMessage.size());
-                _publisher.send(broadcast, zmq::send_flags::none);
+                _publisher.send(MessagePool::getInstance().wrap(broadcastMessage), zmq::send_flags::none);
 
                 std::cout << "Peer connected. Assigned Peer ID: " << peerID << ", Entity ID: " << assignedEntity->getEntityID() << std::endl;
             }
             else {
                 // Showing error message when a peer tries to join after all player entities are already assigned 
                 std::string response = "ERROR|No available player entities";
-                zmq::message_t reply(response.size());
-                memcpy(reply.data(), response.c_str(), response.size());
-                _responder.send(reply, zmq::send_flags::none);
+                _responder.send(MessagePool::getInstance().wrap(response), zmq::send_flags::none);
 
                 std::cout << "Peer connection attempted, but no available player entities." << std::endl;
             }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Entity.h"
+#include <string>
 #include <vector>
 #include <map>
 #ifdef __APPLE__
@@ -27,6 +28,7 @@ private:
     std::vector<Entity*> _availablePlayerEntities;
     std::vector<Entity*> _allEntities;
     std::map<int, Entity*> _peerEntityMap;                 // Map of peerID to assigned player entity
+    std::string _serializedWorld;                          // World entities of the handshake, serialized on first connect
 
     int _nextPeerID;
     int _hostPeerID = -1;                                  // To keep track of the host peer (first peer that connects to server)
@@ -0,0 +1,192 @@
+#include "Room.h"
+#include "Server.h"
+#include "ServerHost.h"
+#include "MessagePool.h"
+#include "TypedEventHandler.h"
+#include "InputEvent.cpp"
+#include "SpawnEvent.cpp"
+#include "Profiler.h"
+#include <algorithm>
+
+Room::Room(int roomId, const WorldBuilder& builder) {
+    _roomID = roomId;
+
+    _engine = new GameEngine("Room simulation", 0, 0, Mode::SERVER);
+    _engine->setPhysicsSystem(&_physicsSystem);
+
+    std::vector<Entity*> noEntities;
+    _engine->initialize(noEntities);
+    _engine->setClientMap(_clientMap);
+
+    // The physics system is initialized by the engine, so the world is built afterwards
+    for (Entity* entity : builder(*_engine)) _engine->addEntity(entity);
+    _engine->classifyEntities();
+    _engine->getZoneIndex().rebuild(_engine->getEntities());
+
+    _topic = ServerHost::roomTopic(_roomID);
+    _lastSnapshotTime = std::chrono::steady_clock::now();
+    setUpEventHandlers();
+}
+
+Room::~Room() {
+    for (Entity* entity : _engine->getEntities()) {
+        delete entity;
+    }
+    delete _engine;
+}
+
+// Sets up the handlers for player input and spawning
+void Room::setUpEventHandlers() {
+    const EventHandler inputHandler = TypedEventHandler<InputEvent>([this](const InputEvent* event) {
+        auto it = _clientMap.find(event->getClientID());
+        if (it == _clientMap.end()) return;
+
+        const auto& binding = event->getBinding();
+        Entity* playerEntity = it->second;
+
+        if (binding == _moveLeft) {
+            playerEntity->setVelocityX(-50.0f);
+        }
+        else if (binding == _moveRight) {
+            playerEntity->setVelocityX(50.0f);
+        }
+        else if (binding == _moveUp) {
+            playerEntity->setVelocityY(-50.0f);
+        }
+        else if (binding == _moveDown) {
+            playerEntity->setVelocityY(50.0f);
+        }
+        });
+    _engine->getEventManager()->registerHandler(EventType::Input, inputHandler);
+
+    const EventHandler spawnHandler = TypedEventHandler<SpawnEvent>([](const SpawnEvent* event) {
+        Entity* entity = event->getEntity();
+        if (entity) entity->setOriginalPosition(event->getPosition());
+        });
+    _engine->getEventManager()->registerHandler(EventType::Spawn, spawnHandler);
+}
+
+// Creates the client's player entity and returns the handshake response
+std::string Room::join(int clientId, uint64_t cachedWorldHash, std::string& serializedPlayer) {
+    PROFILE_ZONE("Room::join");
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Position spawnPosition = _engine->getZoneIndex().randomSpawnPosition();
+
+    Entity* playerEntity = new Entity(Position(-100, -100), Size(50, 50));
+    playerEntity->setAccelerationY(9.8f);
+
+    _engine->addEntity(playerEntity);
+    _physicsSystem.addEntity(*playerEntity);
+    _clientMap[clientId] = playerEntity;
+
+    _engine->getEventManager()->raiseEvent(new SpawnEvent(playerEntity, spawnPosition));
+
+    std::string response = std::to_string(clientId) + "|" + std::to_string(playerEntity->getEntityID()) + "|";
+    response += _worldBlob.buildHandshake(_engine->getEntities(), _physicsSystem.getEntities(), cachedWorldHash);
+
+    serializedPlayer = Server::serializeEntity(*playerEntity);
+    return response;
+}
+
+// Removes the client's player entity from the world
+int Room::leave(int clientId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _clientMap.find(clientId);
+    if (it == _clientMap.end()) return -1;
+
+    Entity* playerEntity = it->second;
+    _clientMap.erase(it);
+    _pendingAcks.erase(clientId);
+
+    _engine->removeEntity(playerEntity);
+
+    int entityId = playerEntity->getEntityID();
+    delete playerEntity;
+    return entityId;
+}
+
+// Converts a button press into an input event for the client's player entity
+void Room::handleInput(int clientId, const std::string& buttonPress, uint32_t sequence) {
+    keyBinding binding;
+
+    if (buttonPress == "left") binding = _moveLeft;
+    else if (buttonPress == "right") binding = _moveRight;
+    else if (buttonPress == "up") binding = _moveUp;
+    else if (buttonPress == "down") binding = _moveDown;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _engine->getEventManager()->raiseEvent(new InputEvent(binding, clientId));
+    if (sequence != 0 && _clientMap.count(clientId)) _pendingAcks[clientId] = sequence;
+}
+
+// Runs one simulation step on the calling (simulation) thread
+void Room::tick() {
+    PROFILE_ZONE("Room::tick");
+    std::lock_guard<std::mutex> lock(_mutex);
+    _engine->step();
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - _lastSnapshotTime >= _snapshotInterval) {
+        // Written with the room's topic in front, so it can be published without another copy
+        _snapshotScratch.clear();
+        _snapshotScratch += _topic;
+        _dynamicEntities.clear();
+        for (Entity* entity : _engine->getEntities()) {
+            if (!entity->isStatic()) _dynamicEntities.push_back(entity);
+        }
+        // Every client of the room gets the snapshot, so it acknowledges all pending inputs
+        _snapshotAcks.assign(_pendingAcks.begin(), _pendingAcks.end());
+        _pendingAcks.clear();
+        Server::writeEntityUpdateMessage(_dynamicEntities, _snapshotScratch, &_snapshotAcks);
+        _lastSnapshotTime = now;
+
+        std::lock_guard<std::mutex> snapshotLock(_snapshotMutex);
+        _snapshot.swap(_snapshotScratch);
+        _hasSnapshot = true;
+    }
+}
+
+bool Room::takeSnapshot(zmq::message_t& snapshot) {
+    std::lock_guard<std::mutex> lock(_snapshotMutex);
+    if (!_hasSnapshot) return false;
+
+    snapshot = MessagePool::getInstance().wrap(_snapshot);
+    _hasSnapshot = false;
+    return true;
+}
+
+void Room::markStaticModified(Entity* entity) {
+    _engine->invalidateStaticWorld();
+
+    std::lock_guard<std::mutex> lock(_snapshotMutex);
+    if (std::find(_modifiedStatic.begin(), _modifiedStatic.end(), entity) == _modifiedStatic.end()) {
+        _modifiedStatic.push_back(entity);
+    }
+}
+
+bool Room::takeStaticUpdate(std::string& message) {
+    std::vector<Entity*> modified;
+    {
+        std::lock_guard<std::mutex> lock(_snapshotMutex);
+        if (_modifiedStatic.empty()) return false;
+        modified.swap(_modifiedStatic);
+    }
+
+    // The entities are read, and the handshake world is rebuilt, while no step is running
+    std::lock_guard<std::mutex> lock(_mutex);
+    _worldBlob.invalidate();
+    message = Server::buildStaticUpdateMessage(modified);
+    return true;
+}
+
+size_t Room::getPlayerCount() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _clientMap.size();
+}
+
+// Setters and getters
+int Room::getRoomID() const { return _roomID; }
+GameEngine* Room::getGameEngine() const { return _engine; }
+void Room::setSnapshotInterval(std::chrono::milliseconds interval) { _snapshotInterval = interval; }
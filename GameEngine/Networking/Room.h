@@ -0,0 +1,82 @@
+#pragma once
+
+#include "GameEngine.h"
+#include "PhysicsSystem.h"
+#include "Server.h"
+#include "WorldBlob.h"
+#include "MessagePool.h"
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Builds the entities of a room's world. Entities must be allocated with 'new'; the room owns them.
+// The room's engine is passed in so that the builder can register entities with its physics system.
+using WorldBuilder = std::function<std::vector<Entity*>(GameEngine&)>;
+
+// One independent world hosted by a ServerHost. A room owns its entities, game engine (with its own
+// event manager and timeline) and physics system. The network-facing methods are thread-safe: they
+// are called from the host's network thread while the room is ticked on a simulation thread.
+class Room {
+public:
+	Room(int roomId, const WorldBuilder& builder);
+	~Room();
+
+	Room(const Room&) = delete;
+	void operator=(const Room&) = delete;
+
+	// Creates a player entity for the client inside a random spawn zone. Returns the handshake response
+	// ("clientID|entityID|world", see WorldBlob) and the serialized player entity to broadcast to other clients.
+	// The static world is left out of the response if the client has the one with 'cachedWorldHash'.
+	std::string join(int clientId, uint64_t cachedWorldHash, std::string& serializedPlayer);
+	// Removes the client's player entity. Returns the ID of the removed entity, or -1 if there was none.
+	int leave(int clientId);
+	// Raises an input event for the client's player. A non-zero 'sequence' is acknowledged in the next snapshot.
+	void handleInput(int clientId, const std::string& buttonPress, uint32_t sequence = 0);
+
+	// Advances the simulation by one step. Refreshes the snapshot if the snapshot interval elapsed.
+	void tick();
+	// Moves the latest snapshot, prefixed with the room's topic, into a message without copying it.
+	// Returns false if there is no new snapshot.
+	bool takeSnapshot(zmq::message_t& snapshot);
+	// Static entities (see Entity::isStatic) are left out of snapshots. Call after moving, resizing or retyping one;
+	// it is sent to the room's clients once and the handshake world is rebuilt. Safe to call from any thread.
+	void markStaticModified(Entity* entity);
+	// Builds the message with the static entities modified since the last call (see Server::buildStaticUpdateMessage).
+	// Returns false if there are none.
+	bool takeStaticUpdate(std::string& message);
+
+	int getRoomID() const;
+	GameEngine* getGameEngine() const;
+	size_t getPlayerCount();
+	void setSnapshotInterval(std::chrono::milliseconds interval);
+
+private:
+	int _roomID;
+	GameEngine* _engine;                                                   // Its entity list holds every entity of the room
+	PhysicsSystem _physicsSystem;                                          // Each room simulates its own bodies
+	std::vector<Entity*> _dynamicEntities;                                 // Entities that snapshots carry
+	std::vector<Entity*> _modifiedStatic;                                  // Guarded by _snapshotMutex
+	std::map<int, Entity*> _clientMap;                                     // Client ID to player entity
+	std::map<int, uint32_t> _pendingAcks;                                  // Latest input of each client since the last snapshot, guarded by _mutex
+	std::vector<Server::InputAck> _snapshotAcks;
+	WorldBlob _worldBlob;
+
+	std::mutex _mutex;                                                     // Guards the world against the network thread
+	std::mutex _snapshotMutex;
+	std::string _snapshot;                                                 // Latest serialized world state
+	std::string _snapshotScratch;                                          // Reused to build the next snapshot
+	std::string _topic;
+	bool _hasSnapshot = false;
+	std::chrono::milliseconds _snapshotInterval = std::chrono::milliseconds(16);
+	std::chrono::steady_clock::time_point _lastSnapshotTime;
+
+	keyBinding _moveLeft = { SDL_SCANCODE_LEFT };
+	keyBinding _moveRight = { SDL_SCANCODE_RIGHT };
+	keyBinding _moveUp = { SDL_SCANCODE_UP };
+	keyBinding _moveDown = { SDL_SCANCODE_DOWN };
+
+	void setUpEventHandlers();
+};
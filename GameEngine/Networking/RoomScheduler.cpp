@@ -0,0 +1,73 @@
+#include "RoomScheduler.h"
+#include "Profiler.h"
+#include <algorithm>
+
+RoomScheduler::RoomScheduler(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    _assignments.resize(threadCount);
+}
+
+RoomScheduler::~RoomScheduler() {
+    stop();
+}
+
+// Assigns the room to the next simulation thread
+void RoomScheduler::addRoom(Room* room) {
+    _assignments[_nextThread].push_back(room);
+    _nextThread = (_nextThread + 1) % _assignments.size();
+}
+
+// Starts one simulation thread per assignment list
+void RoomScheduler::start() {
+    if (_running.exchange(true)) return;
+
+    for (size_t i = 0; i < _assignments.size(); i++) {
+        _threads.emplace_back([this, i]() { threadLoop(i); });
+    }
+}
+
+// Stops the simulation threads and waits for them to finish their current tick
+void RoomScheduler::stop() {
+    if (!_running.exchange(false)) return;
+
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+// Ticks the thread's rooms at a fixed rate. When a tick overruns the interval the schedule is
+// reset to the current time instead of trying to catch up, so an overloaded thread does not spiral.
+void RoomScheduler::threadLoop(size_t threadIndex) {
+    PROFILE_THREAD("Room simulation " + std::to_string(threadIndex));
+    const std::vector<Room*>& rooms = _assignments[threadIndex];
+    auto nextTick = std::chrono::steady_clock::now();
+
+    while (_running) {
+        auto start = std::chrono::steady_clock::now();
+        for (Room* room : rooms) {
+            room->tick();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        _tickCount += rooms.size();
+        _busyTimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+        nextTick += _tickInterval;
+        if (end > nextTick) {
+            _lateTickCount++;
+            nextTick = end;
+        }
+        else {
+            std::this_thread::sleep_until(nextTick);
+        }
+    }
+}
+
+void RoomScheduler::setTickInterval(std::chrono::nanoseconds interval) { _tickInterval = interval; }
+int RoomScheduler::getThreadCount() const { return static_cast<int>(_assignments.size()); }
+uint64_t RoomScheduler::getTickCount() const { return _tickCount; }
+uint64_t RoomScheduler::getLateTickCount() const { return _lateTickCount; }
+int64_t RoomScheduler::getBusyTimeNs() const { return _busyTimeNs; }
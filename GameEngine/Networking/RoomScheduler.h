@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Room.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Runs rooms on a fixed pool of simulation threads. Rooms are assigned to threads round-robin
+// and every thread ticks all of its rooms once per tick interval.
+class RoomScheduler {
+public:
+    explicit RoomScheduler(int threadCount = 0);                            // 0 uses one thread per hardware core
+    ~RoomScheduler();
+
+    // Rooms must be added before the scheduler is started
+    void addRoom(Room* room);
+    void start();
+    void stop();
+
+    void setTickInterval(std::chrono::nanoseconds interval);
+    int getThreadCount() const;
+
+    // Statistics across all simulation threads
+    uint64_t getTickCount() const;                                      // Room ticks executed
+    uint64_t getLateTickCount() const;                                  // Thread iterations that overran the tick interval
+    int64_t getBusyTimeNs() const;                                      // Time spent ticking rooms
+
+private:
+    void threadLoop(size_t threadIndex);
+
+    std::vector<std::vector<Room*>> _assignments;                       // Rooms ticked by each thread
+    std::vector<std::thread> _threads;
+    size_t _nextThread = 0;
+    std::atomic<bool> _running{ false };
+    std::chrono::nanoseconds _tickInterval = std::chrono::nanoseconds(1'000'000'000 / 60);
+
+    std::atomic<uint64_t> _tickCount{ 0 };
+    std::atomic<uint64_t> _lateTickCount{ 0 };
+    std::atomic<int64_t> _busyTimeNs{ 0 };
+};
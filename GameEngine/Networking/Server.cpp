@@ -2,10 +2,20 @@
 #include "TypedEventHandler.h"
 #include "InputEvent.cpp"
 #include "SpawnEvent.cpp"
+#include "Profiler.h"
+#include "MessagePool.h"
+#include <algorithm>
 #include <iostream>
 #include <thread>
 #include <chrono>
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 
 Server::Server(const std::vector<Entity*>& entities) {
     _context = zmq::context_t(1); 
@@ -14,14 +24,13 @@ Server::Server(const std::vector<Entity*>& entities) {
     _subscriber = zmq::socket_t(_context, zmq::socket_type::sub);
     _heartbeatSubscriber = zmq::socket_t(_context, zmq::socket_type::sub);
     _responder = zmq::socket_t(_context, zmq::socket_type::rep);
+    _metricsPublisher = zmq::socket_t(_context, zmq::socket_type::pub);
     
-    _allEntities = entities;
-
     _nextClientID = 0;
-    _nextEntityID = entities.size();
     
     _engine = new GameEngine("Server-side simulation", 0, 0, Mode::SERVER);
-    _engine->initialize(_allEntities);
+    std::vector<Entity*> world = entities;
+    _engine->initialize(world);
     _engine->setClientMap(_clientMap);
 
     setRefreshRate();
@@ -34,6 +43,7 @@ Server::~Server() {
     _subscriber.close();
     _heartbeatSubscriber.close();
     _publisher.close();
+    _metricsPublisher.close();
     _engine->shutdown();
 }
 
@@ -69,6 +79,7 @@ void Server::setUpEventHandlers() {
     // Handler for spawn events    
     const EventHandler spawnHandler = TypedEventHandler<SpawnEvent>([](const SpawnEvent* event) {
         Entity* entity = event->getEntity();
+        if (!entity) return;                              // The client disconnected before the spawn
         Position position = event->getPosition();
         entity->setOriginalPosition(position);  
         });
@@ -86,6 +97,7 @@ void Server::initialize(int entityPubPort, int subPort, int reqPort, int heartbe
 
     _subscriber.set(zmq::sockopt::subscribe, "");
     _heartbeatSubscriber.set(zmq::sockopt::subscribe, "");
+    _heartbeatSubscriber.set(zmq::sockopt::rcvtimeo, 100);                  // Lets the heartbeat thread block instead of spinning
 
     printf("Server started and listening on the following ports:\n");
     printf("Entity updates publisher port: %d\n", entityPubPort);
@@ -99,6 +111,7 @@ void Server::initialize(int entityPubPort, int subPort, int reqPort, int heartbe
 // about the game world to clients.
 void Server::run() {
     std::thread gameEngineThread([this]() {
+        PROFILE_THREAD("Server simulation");
         try {
             _engine->run();  
         }
@@ -109,16 +122,20 @@ void Server::run() {
         });
 
     std::thread clientThread([this]() {
+        PROFILE_THREAD("Server network");
         while (true) {
+            broadcastStaticUpdates();                                                  // Before handshakes, so new clients get the current world
             handleClientHandeshake();
             listenToClientMessages();
             monitorHeartbeats();
             updateClientEntities();
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));              // 60hz tick rate
+            publishMetrics();
+            std::this_thread::sleep_for(_networkTick);                               // Snapshot rate, at least 60hz for inputs
         }
     });
 
     std::thread heartbeatThread([this]() {
+        PROFILE_THREAD("Server heartbeats");
         while (true) {
             listenToHeartbeatMessages();              
         }
@@ -131,69 +148,46 @@ void Server::run() {
 
 // Returns the initial world info to clients who request it
 void Server::handleClientHandeshake() {
+    PROFILE_ZONE("Server::handleClientHandeshake");
     zmq::message_t request;
 
     if (_responder.recv(request, zmq::recv_flags::dontwait)) {
         std::string clientRequest(static_cast<char*>(request.data()), request.size());
-        if (clientRequest == "CONNECT") {
+        if (clientRequest.rfind("CONNECT", 0) == 0) {
             int clientId = _nextClientID++;
 
-            // Collect all spawn points from the _allEntities list
-            std::vector<Entity*> spawnPoints;
-            for (Entity* entity : _allEntities) {
-                if (entity->getZoneType() == ZoneType::SPAWN) {
-                    spawnPoints.push_back(entity);
-                }
-            }
-
-            // Throw an error if no spawn points are found
-            if (spawnPoints.empty()) {
-                throw std::runtime_error("No spawn points found in the world!");
-            }
-
-            // Pick a random spawn point
-            int randomIndex = rand() % spawnPoints.size();
-            Entity* spawnPoint = spawnPoints[randomIndex];
-
-            // Get the spawn point's position and size
-            Position spawnPos = spawnPoint->getOriginalPosition();
-            Size spawnSize = spawnPoint->getSize();
-
-            // Generate a random position within the spawn point boundaries
-            float playerX = spawnPos.x + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (spawnSize.width - 50)));
-            float playerY = spawnPos.y + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (spawnSize.height - 50)));
+            // Pick a random position within one of the spawn points
+            Position spawnPosition = _engine->getZoneIndex().randomSpawnPosition();
 
             // Creating a player entity 
             Entity* playerEntity = new Entity(Position(-100, -100), Size(50, 50));
-            playerEntity->setEntityID(_nextEntityID++);
             playerEntity->setAccelerationY(9.8f);
 
-            // Pushing the player entity into entity lists in the game engine and physics system
-            _engine->getEntities().push_back(playerEntity);
-            _engine->getPhysicsSystem()->getEntities().push_back(playerEntity);
+            // Adding the player entity to the world and the physics system
+            _engine->addEntity(playerEntity);
+            _engine->getPhysicsSystem()->addEntity(*playerEntity);
 
             // Store the player entity in the client Map
             _clientMap[clientId] = playerEntity;
-            _allEntities.push_back(playerEntity);
 
-            // Initialize last heartbeat time
-            _lastHeartbeatMap[clientId] = std::chrono::steady_clock::now();
+            // Start tracking the client's session
+            _sessions.addSession(clientId);
+            _metrics.addClient(clientId);
+            _metrics.recordReceived(clientId, request.size());
+            _snapshotScheduler.addClient(clientId, WorldBlob::parseBandwidth(clientRequest));
 
-            printf("Client connected with ID: %d, created Player Entity ID: %d at Spawn Point (%f, %f)\n",
-                clientId, playerEntity->getEntityID(), spawnPos.x, spawnPos.y);
+            printf("Client connected with ID: %d, created Player Entity ID: %d at (%f, %f)\n",
+                clientId, playerEntity->getEntityID(), spawnPosition.x, spawnPosition.y);
 
             // Raise a SpawnEvent to position the player entity
-            _engine->getEventManager()->raiseEvent(new SpawnEvent(playerEntity, Position(playerX, playerY)));
+            _engine->getEventManager()->raiseEvent(new SpawnEvent(playerEntity, spawnPosition));
 
-            // Create response with client ID, assigned entity ID, and all entity data
+            // Create response with client ID, assigned entity ID, and the world (see WorldBlob)
             std::string response = std::to_string(clientId) + "|" + std::to_string(playerEntity->getEntityID()) + "|";
-            for (const auto& entity : _allEntities) {
-                response += serializeEntity(*entity) + "\n";
-            }
+            response += _worldBlob.buildHandshake(_engine->getEntities(), _engine->getPhysicsSystem()->getEntities(), WorldBlob::parseCachedHash(clientRequest));
 
-            zmq::message_t reply(response.size());
-            memcpy(reply.data(), response.c_str(), response.size());
-            _responder.send(reply, zmq::send_flags::none);
+            _metrics.recordSent(clientId, response.size());
+            _responder.send(MessagePool::getInstance().wrap(response), zmq::send_flags::none);
 
             // Notify all other clients about this new connection
             broadcastNewConnection(playerEntity);
@@ -204,19 +198,11 @@ void Server::handleClientHandeshake() {
 // Moniors heartbeats of the clients to detect disconnects. Delegates to
 // 'handleClientDisconnect' method upon detecting a disconnect.
 void Server::monitorHeartbeats() {    
-    auto now = std::chrono::steady_clock::now();
+    PROFILE_ZONE("Server::monitorHeartbeats");
+    std::vector<int> expired = _sessions.collectExpired();
+    _metrics.recordHeartbeatMisses(expired.size());
 
-    std::vector<int> disconnectedClients;
-
-    for (const auto& [clientId, lastHeartbeat] : _lastHeartbeatMap) {
-        auto durationSinceLastHeartbeat = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastHeartbeat);
-        
-        if (durationSinceLastHeartbeat > _heartbeatTimeout) {
-            disconnectedClients.push_back(clientId);
-        }
-    }
-
-    for (int clientId : disconnectedClients) {
+    for (int clientId : expired) {
         handleClientDisconnect(clientId);
     }    
 }
@@ -225,20 +211,16 @@ void Server::monitorHeartbeats() {
 void Server::handleClientDisconnect(int clientId) {
     printf("Client with ID: %d disconnected.\n", clientId);
 
-    // Remove player entity from the game engine, physics system, and all entities list
+    // Remove player entity from the game engine and the physics system
     Entity* playerEntity = _clientMap[clientId];
+    _engine->removeEntity(playerEntity);
 
-    auto& gameEntities = _engine->getEntities();
-    gameEntities.erase(std::remove(gameEntities.begin(), gameEntities.end(), playerEntity), gameEntities.end());
-    
-    auto& physicsEntities = _engine->getPhysicsSystem()->getEntities();
-    physicsEntities.erase(std::remove(physicsEntities.begin(), physicsEntities.end(), playerEntity), physicsEntities.end());
-    
-    _allEntities.erase(std::remove(_allEntities.begin(), _allEntities.end(), playerEntity), _allEntities.end());
-
-    // Remove from the client map and heartbeat map
+    // Remove from the client map and stop tracking the session
     _clientMap.erase(clientId);
-    _lastHeartbeatMap.erase(clientId);
+    _metrics.removeClient(clientId);
+    _sessions.removeSession(clientId);
+    _snapshotScheduler.removeClient(clientId);
+    _pendingAcks.erase(clientId);
 
     // Inform all clients about the disconnection
     broadcastDisconnect(playerEntity->getEntityID());
@@ -254,10 +236,44 @@ void Server::broadcastNewConnection(Entity* playerEntity) {
     };
 
     std::string message = newConnectionMessage.dump();
-    zmq::message_t zmqMessage(message.size());
-    memcpy(zmqMessage.data(), message.c_str(), message.size());
+    _metrics.recordBroadcast(message.size());
+    _publisher.send(MessagePool::getInstance().wrap(message), zmq::send_flags::none);
+}
+
+void Server::markStaticModified(Entity* entity) {
+    _engine->invalidateStaticWorld();
 
-    _publisher.send(zmqMessage, zmq::send_flags::none);
+    std::lock_guard<std::mutex> lock(_staticMutex);
+    if (std::find(_modifiedStatic.begin(), _modifiedStatic.end(), entity) == _modifiedStatic.end()) {
+        _modifiedStatic.push_back(entity);
+    }
+}
+
+// Sends the static entities modified since the last network tick to all clients. New clients get
+// them with the rebuilt handshake world.
+void Server::broadcastStaticUpdates() {
+    std::vector<Entity*> modified;
+    {
+        std::lock_guard<std::mutex> lock(_staticMutex);
+        if (_modifiedStatic.empty()) return;
+        modified.swap(_modifiedStatic);
+    }
+
+    _worldBlob.invalidate();
+    std::string message = buildStaticUpdateMessage(modified);
+    _metrics.recordBroadcast(message.size());
+    _publisher.send(MessagePool::getInstance().wrap(message), zmq::send_flags::none);
+}
+
+std::string Server::buildStaticUpdateMessage(const std::vector<Entity*>& entities) {
+    json staticUpdateMessage = {
+        {"type", "static_update"},
+        {"entities", json::array()}
+    };
+    for (const Entity* entity : entities) {
+        staticUpdateMessage["entities"].push_back(serializeEntity(*entity));
+    }
+    return staticUpdateMessage.dump();
 }
 
 // Broadcasts a disconnect message to all clients
@@ -268,53 +284,54 @@ void Server::broadcastDisconnect(int playerEntityID) {
     };
 
     std::string message = disconnectMessage.dump();
-    zmq::message_t zmqMessage(message.size());
-    memcpy(zmqMessage.data(), message.c_str(), message.size());
-
-    _publisher.send(zmqMessage, zmq::send_flags::none);  
+    _metrics.recordBroadcast(message.size());
+    _publisher.send(MessagePool::getInstance().wrap(message), zmq::send_flags::none);
 }
 
-// Listens to heartbeat messages from clients
+// Listens to heartbeat messages from clients. Blocks for up to the socket's receive timeout
+// and drains every pending heartbeat, so the heartbeat thread stays idle between messages.
 void Server::listenToHeartbeatMessages() {
+    PROFILE_ZONE("Server::listenToHeartbeatMessages");
     try {
         zmq::message_t request;
-        if (_heartbeatSubscriber.recv(request, zmq::recv_flags::dontwait)) {
-            std::string message(static_cast<char*>(request.data()), request.size());
-            json jsonMessage = json::parse(message);
-            
-            if (jsonMessage["type"] == "heartbeat") {
-                int clientId = jsonMessage["clientId"];
-                _lastHeartbeatMap[clientId] = std::chrono::steady_clock::now();                 
+        zmq::recv_flags flags = zmq::recv_flags::none;
+
+        while (_heartbeatSubscriber.recv(request, flags)) {
+            int clientId = SessionManager::parseHeartbeat(static_cast<const char*>(request.data()), request.size());
+            if (clientId >= 0) {
+                _sessions.touch(clientId);
+                _metrics.recordReceived(clientId, request.size());
             }
+            flags = zmq::recv_flags::dontwait;
         }
     }
-    catch (const nlohmann::json::exception& e) {
-        std::cerr << "JSON parsing error: " << e.what() << std::endl;
-    }
     catch (const std::exception& e) {
         std::cerr << "Error processing heartbeat: " << e.what() << std::endl;
     }
 }
 
 
-// Listens to the button press data from clients 
+// Listens to the button press data from clients. Every message also counts as a heartbeat.
 void Server::listenToClientMessages() {
+    PROFILE_ZONE("Server::listenToClientMessages");
     try {
         zmq::message_t request;
-        if (_subscriber.recv(request, zmq::recv_flags::dontwait)) {
-            std::string message(static_cast<char*>(request.data()), request.size());
-
-            json jsonMessage = json::parse(message);
+        while (_subscriber.recv(request, zmq::recv_flags::dontwait)) {
+            const char* message = static_cast<const char*>(request.data());
+            json jsonMessage = json::parse(message, message + request.size());
 
             // Extract the message type and client ID
             std::string messageType = jsonMessage["type"];            
             int clientId = jsonMessage["clientId"];
+            _sessions.touch(clientId);
+            _metrics.recordReceived(clientId, request.size());
 
             // Handle keypress messages
             if (messageType == "keypress") {
                 std::string buttonPress = jsonMessage["buttonPress"];
                 printf("Received input from Client %d: %s\n", clientId, buttonPress.c_str());
                 processClientInput(clientId, buttonPress);
+                if (jsonMessage.contains("seq") && _clientMap.count(clientId)) _pendingAcks[clientId] = jsonMessage["seq"].get<uint32_t>();
             }            
         }
     }
@@ -414,33 +431,208 @@ json entityToJson(const Entity& entity) {
 
 constexpr bool useJSON = true;
 
-// Broadcasts entity updates to all clients
-void Server::updateClientEntities() {
-    std::string allEntitiesData;
+// Appends the shortest decimal form of a float that parses back to the same value
+static void appendNumber(std::string& out, float value) {
+    if (!std::isfinite(value)) {
+        out += '0';
+        return;
+    }
+    char digits[32];
+#if defined(__cpp_lib_to_chars)
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+#else
+    for (int precision = 6; precision <= 9; precision++) {
+        int length = snprintf(digits, sizeof(digits), "%.*g", precision, value);
+        if (precision == 9 || std::strtof(digits, nullptr) == value) {
+            out.append(digits, length);
+            return;
+        }
+    }
+#endif
+}
 
-    if (useJSON) {
-        json updateMessage = {
-            {"type", "entity_update"},
-            {"entities", json::array()}
-        };
+// Appends an integer in decimal. Written by hand, since std::to_chars is not available before C++17.
+static void appendNumber(std::string& out, int64_t value) {
+    char digits[24];
+    char* end = digits + sizeof(digits);
+    char* start = end;
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    do {
+        *--start = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0) *--start = '-';
+    out.append(start, end);
+}
 
-        for (const Entity* entity : _allEntities) {
-            updateMessage["entities"].push_back(entityToJson(*entity));
+static void appendString(std::string& out, const std::string& text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
         }
+        else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Writes the same document as entityToJson, without building a JSON tree
+static void appendEntityJson(std::string& out, const Entity& entity) {
+    SDL_Color color = entity.getColor();
+
+    out += "{\"id\":"; appendNumber(out, static_cast<int64_t>(entity.getEntityID()));
+    out += ",\"x\":"; appendNumber(out, entity.getOriginalPosition().x);
+    out += ",\"y\":"; appendNumber(out, entity.getOriginalPosition().y);
+    out += ",\"width\":"; appendNumber(out, entity.getSize().width);
+    out += ",\"height\":"; appendNumber(out, entity.getSize().height);
+    out += ",\"type\":\""; out += entityTypeToString(entity.getEntityType());
+    out += "\",\"zoneType\":\""; out += zoneTypeToString(entity.getZoneType());
+    out += "\",\"velocityX\":"; appendNumber(out, entity.getVelocityX());
+    out += ",\"velocityY\":"; appendNumber(out, entity.getVelocityY());
+    out += ",\"accelerationX\":"; appendNumber(out, entity.getAccelerationX());
+    out += ",\"accelerationY\":"; appendNumber(out, entity.getAccelerationY());
+    out += ",\"rotationAngle\":"; appendNumber(out, entity.getRotationAngle());
+    out += ",\"texturePath\":"; appendString(out, entity.getTexturePath());
+    out += ",\"cr\":"; appendNumber(out, static_cast<int64_t>(color.r));
+    out += ",\"cg\":"; appendNumber(out, static_cast<int64_t>(color.g));
+    out += ",\"cb\":"; appendNumber(out, static_cast<int64_t>(color.b));
+    out += ",\"ca\":"; appendNumber(out, static_cast<int64_t>(color.a));
+    out += '}';
+}
+
+// Builds the entity update message for the given entities
+std::string Server::buildEntityUpdateMessage(const std::vector<Entity*>& entities) {
+    std::string message;
+    writeEntityUpdateMessage(entities, message);
+    return message;
+}
+
+// Serializes the entity update message straight into the buffer, so a reused buffer makes no allocations
+void Server::writeEntityUpdateMessage(const std::vector<Entity*>& entities, std::string& out, const std::vector<InputAck>* acks) {
+    PROFILE_ZONE("Server::buildEntityUpdateMessage");
+    if (useJSON) {
+        out += "{\"type\":\"entity_update\",\"serverTime\":";
+        appendNumber(out, wallClockUs());
+        if (acks && !acks->empty()) {
+            out += ",\"acks\":[";
+            for (size_t i = 0; i < acks->size(); i++) {
+                if (i > 0) out += ',';
+                out += '['; appendNumber(out, static_cast<int64_t>((*acks)[i].first));
+                out += ','; appendNumber(out, static_cast<int64_t>((*acks)[i].second));
+                out += ']';
+            }
+            out += ']';
+        }
+        out += ",\"entities\":[";
 
-        allEntitiesData = updateMessage.dump();
+        for (size_t i = 0; i < entities.size(); i++) {
+            if (i > 0) out += ',';
+            appendEntityJson(out, *entities[i]);
+        }
+        out += "]}";
     } else {
-        std::ostringstream oss;
-        oss << "entity_update|";
-        for (const Entity* entity : _allEntities) {
-            oss << "||" << entityToString(*entity);
+        out += "entity_update|";
+        for (const Entity* entity : entities) {
+            out += "||" + entityToString(*entity);
+        }
+    }
+}
+
+int64_t Server::wallClockUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+// Sends entity updates to every client whose next snapshot is due
+void Server::updateClientEntities() {
+    PROFILE_ZONE("Server::updateClientEntities");
+    auto now = SnapshotScheduler::Clock::now();
+
+    // Static entities are in the handshake and only sent again when modified (see markStaticModified)
+    _dynamicEntities.clear();
+    for (Entity* entity : _engine->getEntities()) {
+        if (!entity->isStatic()) _dynamicEntities.push_back(entity);
+    }
+
+    // Every client gets its snapshot on its own topic. The whole world is encoded once per tick, acknowledging
+    // the pending input of every client, and sent as the client's topic frame followed by a body frame that
+    // shares the encoded buffer. Only clients the scheduler throttles get a message built for them.
+    zmq::message_t fullSnapshot;
+    bool hasFullSnapshot = false;
+
+    for (const auto& [clientId, playerEntity] : _clientMap) {
+        if (!_snapshotScheduler.schedule(clientId, playerEntity, _dynamicEntities, now, _snapshotEntities)) continue;
+
+        _snapshotBuffer = clientTopic(clientId);
+        size_t bytes;
+        if (_snapshotEntities.size() == _dynamicEntities.size()) {
+            if (!hasFullSnapshot) {
+                _snapshotAcks.assign(_pendingAcks.begin(), _pendingAcks.end());
+                writeEntityUpdateMessage(_dynamicEntities, _fullSnapshot, &_snapshotAcks);
+                fullSnapshot = MessagePool::getInstance().wrap(_fullSnapshot);
+                hasFullSnapshot = true;
+            }
+            zmq::message_t body;
+            body.copy(fullSnapshot);                                          // Shares the buffer, which is freed after the last send
+            bytes = _snapshotBuffer.size() + body.size();
+
+            _entityPublisher.send(zmq::message_t(_snapshotBuffer.data(), _snapshotBuffer.size()), zmq::send_flags::sndmore);
+            _entityPublisher.send(body, zmq::send_flags::none);
+        }
+        else {
+            _snapshotAcks.clear();
+            auto ack = _pendingAcks.find(clientId);
+            if (ack != _pendingAcks.end()) _snapshotAcks.push_back(*ack);
+            writeEntityUpdateMessage(_snapshotEntities, _snapshotBuffer, &_snapshotAcks);
+            bytes = _snapshotBuffer.size();
+
+            _entityPublisher.send(MessagePool::getInstance().wrap(_snapshotBuffer), zmq::send_flags::none);
         }
-        allEntitiesData = oss.str();
+        _pendingAcks.erase(clientId);
+
+        _snapshotScheduler.recordSent(clientId, bytes, _snapshotEntities.size());
+        _metrics.recordSent(clientId, bytes);
     }
+}
+
+std::string Server::clientTopic(int clientId) {
+    return "C" + std::to_string(clientId) + "|";
+}
+
+// Binds the metrics socket. Statistics are published from the network thread.
+void Server::enableMetrics(int metricsPort, int intervalMs) {
+    _metricsPublisher.bind("tcp://*:" + std::to_string(metricsPort));
+    _metricsInterval = std::chrono::milliseconds(intervalMs);
+    _lastMetricsTime = std::chrono::steady_clock::now();
+    _engine->setMetrics(&_metrics);
+    _metricsEnabled = true;
 
-    zmq::message_t message(allEntitiesData.size());
-    memcpy(message.data(), allEntitiesData.c_str(), allEntitiesData.size());
-    _entityPublisher.send(message, zmq::send_flags::none);
+    printf("Metrics publisher port: %d\n", metricsPort);
+}
+
+// Publishes the statistics of the last interval if it has elapsed
+void Server::publishMetrics() {
+    if (!_metricsEnabled) return;
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - _lastMetricsTime < _metricsInterval) return;
+    _lastMetricsTime = now;
+
+    EventManager* eventManager = _engine->getEventManager();
+    std::string message = _metrics.collect(CollisionSystem::getInstance().getPairsTested(),
+        eventManager->getRaisedCount(), eventManager->getProcessedCount(), eventManager->getQueueSize());
+
+    _metricsPublisher.send(MessagePool::getInstance().wrap(message), zmq::send_flags::dontwait);
 }
 
 // Serializes an entity to a JSON string
@@ -455,6 +647,15 @@ void Server::setRefreshRate(RefreshRate rate) {
     _engine->setServerRefreshRateMs(_refreshRateMs);
 }
 
+void Server::setSnapshotRate(int snapshotsPerSecond) {
+    _snapshotScheduler.setSnapshotRate(snapshotsPerSecond);
+    _networkTick = std::chrono::milliseconds(std::max(1, std::min(16, 1000 / _snapshotScheduler.getSnapshotRate())));
+}
+
+void Server::setClientBandwidth(int64_t bytesPerSecond) {
+    _snapshotScheduler.setDefaultBandwidth(bytesPerSecond);
+}
+
 // Changes the game simulation speed
 void Server::setSimulationSpeed(double speed) {
     _engine->setGameSpeed(speed);
@@ -466,5 +667,5 @@ GameEngine* Server::getGameEngine() const { return _engine; }
 
 // Sets the heartbeat timeout value 
 void Server::setHeartBeatTimeout(int milliseconds) {
-    _heartbeatTimeout = std::chrono::milliseconds(milliseconds);
+    _sessions.setTimeout(std::chrono::milliseconds(milliseconds));
 }
\ No newline at end of file
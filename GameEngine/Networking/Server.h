@@ -3,8 +3,13 @@
 #include <Entity.h>
 #include <GameEngine.h>
 #include <Globals.h>
+#include "ServerMetrics.h"
+#include "SessionManager.h"
+#include "SnapshotScheduler.h"
+#include "WorldBlob.h"
 #include <vector>
 #include <map>
+#include <mutex>
 #ifdef __APPLE__
 #include <zmq.hpp>
 #include <nlohmann/json.hpp>
@@ -23,10 +28,25 @@ public:
 
 	void initialize(int entityPubPort = 5555, int subPort = 5556, int reqPort = 5557, int hbSubPort = 5558, int pubPort = 5559);
 	void run();
+	// Publishes live statistics on an extra PUB port every interval (see ServerMetrics). Call after initialize.
+	void enableMetrics(int metricsPort = 5560, int intervalMs = 1000);
 
 	GameEngine* getGameEngine() const;
 
 	static std::string serializeEntity(const Entity& entity);
+	// Client ID and sequence number of the client's latest input
+	using InputAck = std::pair<int, uint32_t>;
+
+	// Builds the entity update message that is broadcast to clients every network tick. JSON messages carry
+	// the wall clock time they were built at ("serverTime"), so clients can measure the age of a snapshot.
+	static std::string buildEntityUpdateMessage(const std::vector<Entity*>& entities);
+	// Appends the entity update message to 'out'. Acknowledged inputs are listed as "acks", so that
+	// clients can time the round trip of their inputs on their own clock.
+	static void writeEntityUpdateMessage(const std::vector<Entity*>& entities, std::string& out, const std::vector<InputAck>* acks = nullptr);
+	// Message that sends modified static entities to clients, which apply it by entity ID
+	static std::string buildStaticUpdateMessage(const std::vector<Entity*>& entities);
+	// Wall clock time in microseconds since the epoch. Comparable between processes and between machines with synchronized clocks.
+	static int64_t wallClockUs();
 	void monitorHeartbeats();
 	void handleClientDisconnect(int clientId);
 
@@ -35,21 +55,31 @@ public:
 	int getRefreshRateMs() const;
 	void setSimulationSpeed(double speed);
 	void setHeartBeatTimeout(int milliseconds);
+	// Highest rate at which clients get snapshots, independent of the simulation rate (60 by default)
+	void setSnapshotRate(int snapshotsPerSecond);
+	// Snapshot budget of clients that do not ask for one, in bytes per second (0, the default, is unlimited).
+	// Clients over budget get fewer snapshots and only their most important entities (see SnapshotScheduler).
+	void setClientBandwidth(int64_t bytesPerSecond);
+	// Topic prefix of the snapshots sent to one client
+	static std::string clientTopic(int clientId);
+	// Static entities (see Entity::isStatic) are only in the handshake, not in snapshots. Call after moving,
+	// resizing or retyping one: connected clients get it once, and the engine and the handshake world are rebuilt.
+	// Safe to call from any thread.
+	void markStaticModified(Entity* entity);
 
 	std::map<int, Entity*> _clientMap;                                  // A map between client ID and assigned player entity
 	
 
 private:	
-	std::vector<Entity*> _allEntities;                                   // All entities
 	zmq::context_t _context;
 	zmq::socket_t _entityPublisher;
 	zmq::socket_t _publisher;
 	zmq::socket_t _subscriber;
 	zmq::socket_t _heartbeatSubscriber;
 	zmq::socket_t _responder;	
+	zmq::socket_t _metricsPublisher;
 
 	int _nextClientID;
-	int _nextEntityID;                                                  // To track the proper ID when creating player entities
 
 	GameEngine* _engine;
 
@@ -61,13 +91,31 @@ private:
 	void updateClientEntities();
 	void broadcastDisconnect(int clientId);
 	void broadcastNewConnection(Entity* entity);
+	void broadcastStaticUpdates();
+	void publishMetrics();
 
 	RefreshRate _refreshRate;
 	int _refreshRateMs;
 
-	// A map to track the last heartbeat time for each client
-	std::unordered_map<int, std::chrono::time_point<std::chrono::steady_clock>> _lastHeartbeatMap; 
-	std::chrono::milliseconds _heartbeatTimeout = std::chrono::milliseconds(1000);                  // 1 sec default timeout
+	// Tracks client liveness. Any message from a client refreshes its session (1 sec default timeout)
+	SessionManager _sessions;
+
+	std::string _snapshotBuffer;                                        // Reused for every entity update message
+	std::string _fullSnapshot;                                          // Encodes the whole world once per tick, for every client that gets all of it
+	std::vector<Entity*> _snapshotEntities;                             // Entities selected for one client's snapshot
+	std::vector<Entity*> _dynamicEntities;                              // Entities that snapshots carry
+	std::map<int, uint32_t> _pendingAcks;                               // Latest input of each client that no snapshot acknowledged yet
+	std::vector<InputAck> _snapshotAcks;                                // Acknowledgements written into one snapshot
+	std::mutex _staticMutex;
+	std::vector<Entity*> _modifiedStatic;                               // Static entities to send again, guarded by _staticMutex
+	SnapshotScheduler _snapshotScheduler;
+	std::chrono::milliseconds _networkTick = std::chrono::milliseconds(16);
+	WorldBlob _worldBlob;                                               // Static world sent with every handshake, encoded once
+
+	ServerMetrics _metrics;
+	bool _metricsEnabled = false;
+	std::chrono::milliseconds _metricsInterval;
+	std::chrono::steady_clock::time_point _lastMetricsTime;
 
 	keyBinding _moveLeft = { SDL_SCANCODE_LEFT };
 	keyBinding _moveRight = { SDL_SCANCODE_RIGHT };
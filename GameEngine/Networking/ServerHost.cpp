@@ -0,0 +1,256 @@
+#include "ServerHost.h"
+#include "Profiler.h"
+#include "MessagePool.h"
+#include <iostream>
+#include <thread>
+#ifdef __APPLE__
+#include <nlohmann/json.hpp>
+#else
+#include <JSON/json.hpp>
+#endif
+
+using json = nlohmann::json;
+
+ServerHost::ServerHost(int simulationThreads) : _scheduler(simulationThreads) {
+    _context = zmq::context_t(1);
+    _entityPublisher = zmq::socket_t(_context, zmq::socket_type::pub);
+    _publisher = zmq::socket_t(_context, zmq::socket_type::pub);
+    _subscriber = zmq::socket_t(_context, zmq::socket_type::sub);
+    _heartbeatSubscriber = zmq::socket_t(_context, zmq::socket_type::sub);
+    _responder = zmq::socket_t(_context, zmq::socket_type::rep);
+}
+
+ServerHost::~ServerHost() {
+    _scheduler.stop();
+    _entityPublisher.close();
+    _publisher.close();
+    _subscriber.close();
+    _heartbeatSubscriber.close();
+    _responder.close();
+}
+
+// Creates a room and assigns it to one of the simulation threads
+Room* ServerHost::createRoom(int roomId, const WorldBuilder& builder) {
+    if (_rooms.find(roomId) != _rooms.end()) {
+        throw std::runtime_error("Room " + std::to_string(roomId) + " already exists");
+    }
+
+    Room* room = new Room(roomId, builder);
+    _rooms[roomId] = std::unique_ptr<Room>(room);
+    _scheduler.addRoom(room);
+    return room;
+}
+
+Room* ServerHost::getRoom(int roomId) const {
+    auto it = _rooms.find(roomId);
+    return it == _rooms.end() ? nullptr : it->second.get();
+}
+
+// Binds the shared sockets used by all rooms
+void ServerHost::initialize(int entityPubPort, int subPort, int reqPort, int heartbeatPort, int pubPort) {
+    _entityPublisher.bind("tcp://*:" + std::to_string(entityPubPort));
+    _publisher.bind("tcp://*:" + std::to_string(pubPort));
+    _subscriber.bind("tcp://*:" + std::to_string(subPort));
+    _heartbeatSubscriber.bind("tcp://*:" + std::to_string(heartbeatPort));
+    _responder.bind("tcp://*:" + std::to_string(reqPort));
+
+    _subscriber.set(zmq::sockopt::subscribe, "");
+    _heartbeatSubscriber.set(zmq::sockopt::subscribe, "");
+    _heartbeatSubscriber.set(zmq::sockopt::rcvtimeo, 100);
+
+    printf("Server host started with %d rooms on %d simulation threads.\n",
+        static_cast<int>(_rooms.size()), _scheduler.getThreadCount());
+    printf("Entity updates publisher port: %d\n", entityPubPort);
+    printf("General publisher port: %d\n", pubPort);
+    printf("Subscriber port: %d\n", subPort);
+    printf("Request-Response port: %d\n", reqPort);
+    printf("Heartbeat port: %d\n", heartbeatPort);
+}
+
+// Starts the simulation threads and serves clients of all rooms from this thread
+void ServerHost::run() {
+    _scheduler.start();
+    PROFILE_THREAD("ServerHost network");
+
+    std::thread heartbeatThread([this]() {
+        PROFILE_THREAD("ServerHost heartbeats");
+        while (true) {
+            listenToHeartbeatMessages();
+        }
+        });
+
+    while (true) {
+        publishStaticUpdates();                                                    // Before handshakes, so new clients get the current world
+        handleClientHandshake();
+        listenToClientMessages();
+        monitorHeartbeats();
+        publishSnapshots();
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));              // 60hz network tick rate
+    }
+
+    heartbeatThread.join();
+}
+
+std::string ServerHost::roomTopic(int roomId) {
+    return "R" + std::to_string(roomId) + "|";
+}
+
+// Sends a message prefixed with the room's topic
+void ServerHost::publish(zmq::socket_t& socket, int roomId, std::string message) {
+    socket.send(MessagePool::getInstance().wrap(roomTopic(roomId), message), zmq::send_flags::none);
+}
+
+void ServerHost::reply(std::string response) {
+    _responder.send(MessagePool::getInstance().wrap(response), zmq::send_flags::none);
+}
+
+// Adds connecting clients to the requested room ("CONNECT|<roomID>[|<cached world hash>]", or "CONNECT" for room 0)
+void ServerHost::handleClientHandshake() {
+    PROFILE_ZONE("ServerHost::handleClientHandshake");
+    zmq::message_t request;
+
+    while (_responder.recv(request, zmq::recv_flags::dontwait)) {
+        std::string clientRequest(static_cast<char*>(request.data()), request.size());
+
+        if (clientRequest.rfind("CONNECT", 0) != 0) {
+            reply("ERROR|Invalid request");
+            continue;
+        }
+
+        int roomId = 0;
+        size_t separator = clientRequest.find('|');
+        if (separator != std::string::npos) {
+            roomId = std::atoi(clientRequest.c_str() + separator + 1);
+        }
+
+        Room* room = getRoom(roomId);
+        if (!room) {
+            reply("ERROR|Unknown room");
+            continue;
+        }
+
+        try {
+            int clientId = _nextClientID++;
+            std::string serializedPlayer;
+            std::string response = room->join(clientId, WorldBlob::parseCachedHash(clientRequest), serializedPlayer);
+
+            _clientRooms[clientId] = room;
+            _sessions.addSession(clientId);
+            reply(std::move(response));
+
+            // Notify the other clients in the room about this new connection
+            json newConnectionMessage = {
+                {"type", "new_connection"},
+                {"entity", serializedPlayer}
+            };
+            publish(_publisher, roomId, newConnectionMessage.dump());
+
+            printf("Client connected with ID: %d to room %d\n", clientId, roomId);
+        }
+        catch (const std::exception& e) {
+            reply(std::string("ERROR|") + e.what());
+        }
+    }
+}
+
+// Routes client input to the client's room. Every message also counts as a heartbeat.
+void ServerHost::listenToClientMessages() {
+    PROFILE_ZONE("ServerHost::listenToClientMessages");
+    zmq::message_t request;
+
+    while (_subscriber.recv(request, zmq::recv_flags::dontwait)) {
+        try {
+            json jsonMessage = json::parse(static_cast<const char*>(request.data()),
+                static_cast<const char*>(request.data()) + request.size());
+
+            int clientId = jsonMessage["clientId"];
+            _sessions.touch(clientId);
+
+            auto it = _clientRooms.find(clientId);
+            if (it == _clientRooms.end()) continue;
+
+            if (jsonMessage["type"] == "keypress") {
+                uint32_t sequence = jsonMessage.contains("seq") ? jsonMessage["seq"].get<uint32_t>() : 0;
+                it->second->handleInput(clientId, jsonMessage["buttonPress"], sequence);
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error processing input: " << e.what() << std::endl;
+        }
+    }
+}
+
+// Drains heartbeat messages, blocking for up to the socket's receive timeout
+void ServerHost::listenToHeartbeatMessages() {
+    PROFILE_ZONE("ServerHost::listenToHeartbeatMessages");
+    zmq::message_t request;
+    zmq::recv_flags flags = zmq::recv_flags::none;
+
+    while (_heartbeatSubscriber.recv(request, flags)) {
+        int clientId = SessionManager::parseHeartbeat(static_cast<const char*>(request.data()), request.size());
+        if (clientId >= 0) {
+            _sessions.touch(clientId);
+        }
+        flags = zmq::recv_flags::dontwait;
+    }
+}
+
+void ServerHost::monitorHeartbeats() {
+    PROFILE_ZONE("ServerHost::monitorHeartbeats");
+    for (int clientId : _sessions.collectExpired()) {
+        handleClientDisconnect(clientId);
+    }
+}
+
+// Removes the client's player entity from its room and informs the room's other clients
+void ServerHost::handleClientDisconnect(int clientId) {
+    auto it = _clientRooms.find(clientId);
+    if (it == _clientRooms.end()) return;
+
+    Room* room = it->second;
+    _clientRooms.erase(it);
+    _sessions.removeSession(clientId);
+
+    int entityId = room->leave(clientId);
+    if (entityId < 0) return;
+
+    json disconnectMessage = {
+        {"type", "disconnect"},
+        {"entityID", entityId}
+    };
+    publish(_publisher, room->getRoomID(), disconnectMessage.dump());
+
+    printf("Client with ID: %d disconnected from room %d.\n", clientId, room->getRoomID());
+}
+
+// Publishes the latest snapshot of every room that produced one since the last network tick
+void ServerHost::publishSnapshots() {
+    PROFILE_ZONE("ServerHost::publishSnapshots");
+    zmq::message_t snapshot;
+
+    for (const auto& [roomId, room] : _rooms) {
+        if (room->takeSnapshot(snapshot)) {
+            _entityPublisher.send(snapshot, zmq::send_flags::none);
+        }
+    }
+}
+
+// Publishes the static entities each room modified since the last network tick
+void ServerHost::publishStaticUpdates() {
+    std::string message;
+
+    for (const auto& [roomId, room] : _rooms) {
+        if (room->takeStaticUpdate(message)) {
+            publish(_publisher, roomId, std::move(message));
+        }
+    }
+}
+
+// Sets the simulation rate of all rooms
+void ServerHost::setRefreshRate(RefreshRate rate) {
+    _scheduler.setTickInterval(std::chrono::nanoseconds(1'000'000'000 / static_cast<int>(rate)));
+}
+
+void ServerHost::setHeartBeatTimeout(int milliseconds) {
+    _sessions.setTimeout(std::chrono::milliseconds(milliseconds));
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Room.h"
+#include "RoomScheduler.h"
+#include "SessionManager.h"
+#include <map>
+#include <memory>
+#include <unordered_map>
+#ifdef __APPLE__
+#include <zmq.hpp>
+#else
+#include <ZMQ/zmq.hpp>
+#endif
+
+// Hosts many independent rooms in a single process. The rooms are simulated on a fixed pool of
+// threads (see RoomScheduler) while one network thread serves all of them over a shared set of sockets.
+//
+// Routing: clients join a room with a "CONNECT|<roomID>" handshake ("CONNECT" joins room 0). Client IDs
+// are unique across the host, so input and heartbeat messages are routed by client ID. Messages published
+// to clients are prefixed with the room topic "R<roomID>|", which clients subscribe to.
+class ServerHost {
+public:
+    explicit ServerHost(int simulationThreads = 0);                        // 0 uses one thread per hardware core
+    ~ServerHost();
+
+    // Rooms must be created before the host is run
+    Room* createRoom(int roomId, const WorldBuilder& builder);
+    Room* getRoom(int roomId) const;
+
+    void initialize(int entityPubPort = 5555, int subPort = 5556, int reqPort = 5557, int hbSubPort = 5558, int pubPort = 5559);
+    void run();
+
+    void setRefreshRate(RefreshRate rate = RefreshRate::SIXTY_FPS);
+    void setHeartBeatTimeout(int milliseconds);
+
+    static std::string roomTopic(int roomId);
+
+private:
+    zmq::context_t _context;
+    zmq::socket_t _entityPublisher;
+    zmq::socket_t _publisher;
+    zmq::socket_t _subscriber;
+    zmq::socket_t _heartbeatSubscriber;
+    zmq::socket_t _responder;
+
+    std::map<int, std::unique_ptr<Room>> _rooms;
+    std::unordered_map<int, Room*> _clientRooms;                            // Client ID to the room it joined
+    RoomScheduler _scheduler;
+    SessionManager _sessions;
+    int _nextClientID = 0;
+
+    void handleClientHandshake();
+    void listenToClientMessages();
+    void listenToHeartbeatMessages();
+    void monitorHeartbeats();
+    void publishSnapshots();
+    void publishStaticUpdates();
+    void handleClientDisconnect(int clientId);
+    void publish(zmq::socket_t& socket, int roomId, std::string message);
+    void reply(std::string response);
+};
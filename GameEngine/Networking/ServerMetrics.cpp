@@ -0,0 +1,138 @@
+#include "ServerMetrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+static int64_t unixTimeMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+}
+
+void ServerMetrics::recordTick(int64_t durationNs, size_t entities, size_t asleep) {
+    size_t bucket = 0;
+    for (int64_t us = durationNs / 1000; us > 1 && bucket < HISTOGRAM_BUCKETS - 1; us >>= 1) {
+        bucket++;
+    }
+
+    _tickHistogram[bucket]++;
+    _ticks++;
+    _tickTotalNs += durationNs;
+    _entities = entities;
+    _asleep = asleep;
+
+    int64_t previousMax = _tickMaxNs.load();
+    while (durationNs > previousMax && !_tickMaxNs.compare_exchange_weak(previousMax, durationNs)) {}
+}
+
+void ServerMetrics::recordHeartbeatMisses(size_t count) {
+    _heartbeatMisses += count;
+}
+
+void ServerMetrics::addClient(int clientId) {
+    std::lock_guard<std::mutex> lock(_trafficMutex);
+    ClientTraffic& traffic = _clients[clientId];
+    traffic = ClientTraffic();
+    traffic.broadcastAtJoin = _broadcastBytes;
+}
+
+void ServerMetrics::removeClient(int clientId) {
+    std::lock_guard<std::mutex> lock(_trafficMutex);
+    _clients.erase(clientId);
+}
+
+void ServerMetrics::recordReceived(int clientId, size_t bytes) {
+    std::lock_guard<std::mutex> lock(_trafficMutex);
+    _receivedBytes += bytes;
+
+    auto it = _clients.find(clientId);
+    if (it != _clients.end()) it->second.received += bytes;
+}
+
+void ServerMetrics::recordSent(int clientId, size_t bytes) {
+    std::lock_guard<std::mutex> lock(_trafficMutex);
+    _sentBytes += bytes;
+
+    auto it = _clients.find(clientId);
+    if (it != _clients.end()) it->second.sent += bytes;
+}
+
+// Every connected client receives a copy of a broadcast, so the clients' shares are derived from
+// the running total instead of updating each client here
+void ServerMetrics::recordBroadcast(size_t bytes) {
+    std::lock_guard<std::mutex> lock(_trafficMutex);
+    _broadcastBytes += bytes;
+    _sentBytes += bytes * _clients.size();
+}
+
+std::string ServerMetrics::collect(uint64_t pairsTested, uint64_t eventsRaised, uint64_t eventsProcessed, size_t eventQueueSize) {
+    int64_t now = unixTimeMs();
+    uint64_t ticks = _ticks.exchange(0);
+    int64_t tickTotalNs = _tickTotalNs.exchange(0);
+    int64_t tickMaxNs = _tickMaxNs.exchange(0);
+
+    std::ostringstream oss;
+    oss << "metrics t=" << now
+        << " interval_ms=" << (_lastCollectTime ? now - _lastCollectTime : 0)
+        << " entities=" << _entities.load()
+        << " asleep=" << _asleep.load()
+        << " ticks=" << ticks
+        << " tick_avg_us=" << (ticks ? tickTotalNs / static_cast<int64_t>(ticks) / 1000 : 0)
+        << " tick_max_us=" << tickMaxNs / 1000
+        << " tick_hist=";
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        oss << (i ? "," : "") << _tickHistogram[i].exchange(0);
+    }
+    oss << " pairs=" << pairsTested
+        << " events_raised=" << eventsRaised
+        << " events_processed=" << eventsProcessed
+        << " event_queue=" << eventQueueSize
+        << " hb_misses=" << _heartbeatMisses.load();
+
+    std::lock_guard<std::mutex> lock(_trafficMutex);
+    oss << " clients=" << _clients.size()
+        << " rx=" << _receivedBytes
+        << " tx=" << _sentBytes;
+    for (const auto& [clientId, traffic] : _clients) {
+        oss << " client." << clientId << "=" << traffic.received << "/" << traffic.sent + _broadcastBytes - traffic.broadcastAtJoin;
+    }
+
+    _lastCollectTime = now;
+    return oss.str();
+}
+
+bool ServerMetrics::parse(const std::string& message, std::map<std::string, std::string>& values) {
+    std::istringstream iss(message);
+    std::string token;
+    if (!(iss >> token) || token != "metrics") return false;
+
+    values.clear();
+    while (iss >> token) {
+        size_t separator = token.find('=');
+        if (separator == std::string::npos) continue;
+        values[token.substr(0, separator)] = token.substr(separator + 1);
+    }
+    return true;
+}
+
+double ServerMetrics::histogramPercentile(const std::string& histogram, double percentile) {
+    std::vector<uint64_t> buckets;
+    std::istringstream iss(histogram);
+    std::string count;
+    uint64_t total = 0;
+    while (std::getline(iss, count, ',')) {
+        buckets.push_back(std::stoull(count));
+        total += buckets.back();
+    }
+    if (total == 0) return 0;
+
+    uint64_t target = static_cast<uint64_t>(total * percentile);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen > target) return static_cast<double>(uint64_t(1) << (i + 1));
+    }
+    return static_cast<double>(uint64_t(1) << buckets.size());
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Collects live statistics of a server and formats them for the metrics socket. Recording is
+// thread-safe: ticks are recorded by the simulation thread, traffic by the network threads.
+//
+// Wire format (one message per interval, space separated key=value pairs):
+//   metrics t=<unix ms> interval_ms=<ms> entities=<n> asleep=<n> ticks=<n> tick_avg_us=<us> tick_max_us=<us>
+//   tick_hist=<b0,b1,...> pairs=<total> events_raised=<total> events_processed=<total> event_queue=<n>
+//   hb_misses=<total> clients=<n> rx=<total bytes> tx=<total bytes> client.<id>=<rx bytes>/<tx bytes> ...
+// Tick statistics cover the last interval; bucket i of tick_hist counts ticks of [2^i, 2^(i+1)) us.
+class ServerMetrics {
+public:
+    static constexpr size_t HISTOGRAM_BUCKETS = 20;
+
+    // 'asleep' is the number of entities physics currently skips (see Entity::isAsleep)
+    void recordTick(int64_t durationNs, size_t entities, size_t asleep = 0);
+    void recordHeartbeatMisses(size_t count);
+
+    void addClient(int clientId);
+    void removeClient(int clientId);
+    void recordReceived(int clientId, size_t bytes);
+    void recordSent(int clientId, size_t bytes);
+    // Messages published to all connected clients
+    void recordBroadcast(size_t bytes);
+
+    // Builds the message for the interval since the previous call and starts a new interval.
+    // Counters owned by other systems are passed in.
+    std::string collect(uint64_t pairsTested, uint64_t eventsRaised, uint64_t eventsProcessed, size_t eventQueueSize);
+
+    // Splits a metrics message into its key=value pairs. Returns false if it is not a metrics message.
+    static bool parse(const std::string& message, std::map<std::string, std::string>& values);
+    // Upper bound (us) of the histogram bucket that contains the given percentile
+    static double histogramPercentile(const std::string& histogram, double percentile);
+
+private:
+    struct ClientTraffic {
+        uint64_t received = 0;
+        uint64_t sent = 0;
+        uint64_t broadcastAtJoin = 0;                     // Broadcast bytes published before the client joined
+    };
+
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> _tickHistogram{};
+    std::atomic<uint64_t> _ticks{ 0 };
+    std::atomic<int64_t> _tickTotalNs{ 0 };
+    std::atomic<int64_t> _tickMaxNs{ 0 };
+    std::atomic<size_t> _entities{ 0 };
+    std::atomic<size_t> _asleep{ 0 };
+    std::atomic<uint64_t> _heartbeatMisses{ 0 };
+
+    std::mutex _trafficMutex;
+    std::map<int, ClientTraffic> _clients;
+    uint64_t _broadcastBytes = 0;
+    uint64_t _receivedBytes = 0;
+    uint64_t _sentBytes = 0;
+    int64_t _lastCollectTime = 0;
+};
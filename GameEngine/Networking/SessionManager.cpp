@@ -0,0 +1,134 @@
+#include "SessionManager.h"
+
+#include <algorithm>
+
+SessionManager::SessionManager(std::chrono::milliseconds timeout, std::chrono::milliseconds slotDuration) {
+    _timeoutNs = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+    _slotDurationNs = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(slotDuration).count());
+    _currentTick = toTick(now());
+    rebuildWheel();
+}
+
+int64_t SessionManager::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+int64_t SessionManager::toTick(int64_t timeNs) const {
+    return timeNs / _slotDurationNs;
+}
+
+// Files the session under the slot of the given tick
+void SessionManager::schedule(int clientId, Session& session, int64_t deadlineTick) {
+    session.slot = static_cast<size_t>(deadlineTick % static_cast<int64_t>(_wheel.size()));
+    _wheel[session.slot].push_back(clientId);
+}
+
+// Resizes the wheel so that one revolution covers the timeout, then re-files every session
+void SessionManager::rebuildWheel() {
+    size_t slots = static_cast<size_t>(_timeoutNs / _slotDurationNs) + 2;
+    _wheel.assign(slots, std::vector<int>());
+
+    for (auto& [clientId, session] : _sessions) {
+        schedule(clientId, session, std::max(_currentTick + 1, toTick(session.lastSeen + _timeoutNs) + 1));
+    }
+}
+
+// Starts tracking a newly connected client
+void SessionManager::addSession(int clientId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Session& session = _sessions[clientId];
+    session.lastSeen = now();
+    schedule(clientId, session, toTick(session.lastSeen + _timeoutNs) + 1);
+}
+
+// Stops tracking a client. Its wheel entry is discarded lazily when its slot comes around.
+void SessionManager::removeSession(int clientId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sessions.erase(clientId);
+}
+
+// Refreshes the liveness of a client. The session is not moved in the wheel here; it is
+// re-filed when its old slot is reached, which keeps this call O(1).
+void SessionManager::touch(int clientId) {
+    int64_t timestamp = now();
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _sessions.find(clientId);
+    if (it != _sessions.end()) {
+        it->second.lastSeen = timestamp;
+    }
+}
+
+// Visits the slots between the last processed tick and now. Sessions that were refreshed
+// in the meantime are re-filed under their new deadline, the rest are expired.
+std::vector<int> SessionManager::collectExpired() {
+    std::vector<int> expired;
+    int64_t timestamp = now();
+    int64_t nowTick = toTick(timestamp);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // After a long stall a single revolution is enough to visit every slot
+    int64_t slots = static_cast<int64_t>(_wheel.size());
+    if (nowTick - _currentTick > slots) {
+        _currentTick = nowTick - slots;
+    }
+
+    std::vector<int> due;
+    while (_currentTick < nowTick) {
+        _currentTick++;
+        size_t slot = static_cast<size_t>(_currentTick % slots);
+        if (_wheel[slot].empty()) continue;
+
+        due.swap(_wheel[slot]);
+        for (int clientId : due) {
+            auto it = _sessions.find(clientId);
+
+            // Stale entry: the session was removed or already re-filed elsewhere
+            if (it == _sessions.end() || it->second.slot != slot) continue;
+
+            if (timestamp - it->second.lastSeen > _timeoutNs) {
+                expired.push_back(clientId);
+                _sessions.erase(it);
+            }
+            else {
+                schedule(clientId, it->second, std::max(_currentTick + 1, toTick(it->second.lastSeen + _timeoutNs) + 1));
+            }
+        }
+        due.clear();
+    }
+
+    return expired;
+}
+
+void SessionManager::setTimeout(std::chrono::milliseconds timeout) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _timeoutNs = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+    rebuildWheel();
+}
+
+std::chrono::milliseconds SessionManager::getTimeout() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(_timeoutNs));
+}
+
+size_t SessionManager::getSessionCount() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _sessions.size();
+}
+
+std::string SessionManager::formatHeartbeat(int clientId) {
+    return "HB|" + std::to_string(clientId);
+}
+
+int SessionManager::parseHeartbeat(const char* data, size_t size) {
+    if (size < 4 || data[0] != 'H' || data[1] != 'B' || data[2] != '|') return -1;
+
+    int clientId = 0;
+    for (size_t i = 3; i < size; i++) {
+        if (data[i] < '0' || data[i] > '9') return -1;
+        clientId = clientId * 10 + (data[i] - '0');
+    }
+    return clientId;
+}
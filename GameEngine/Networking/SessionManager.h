@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Tracks the liveness of connected clients. Any message received from a client refreshes
+// its session. Expiry is driven by a hashed timer wheel, so refreshing a session is O(1)
+// and each tick only visits the sessions whose deadline falls into the elapsed slots.
+class SessionManager {
+public:
+    explicit SessionManager(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000),
+        std::chrono::milliseconds slotDuration = std::chrono::milliseconds(50));
+
+    void addSession(int clientId);
+    void removeSession(int clientId);
+
+    // Marks the client as alive. Unknown clients are ignored.
+    void touch(int clientId);
+
+    // Advances the wheel up to the current time and returns the clients whose sessions expired.
+    // Expired sessions are removed from the manager.
+    std::vector<int> collectExpired();
+
+    void setTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds getTimeout() const;
+    size_t getSessionCount();
+
+    // Compact heartbeat wire format: "HB|<clientId>"
+    static std::string formatHeartbeat(int clientId);
+    // Returns the client ID of a heartbeat message, or -1 if the message is not a heartbeat
+    static int parseHeartbeat(const char* data, size_t size);
+
+private:
+    struct Session {
+        int64_t lastSeen;                                 // Last time a message arrived from the client (ns)
+        size_t slot;                                      // Wheel slot the session is currently filed under
+    };
+
+    static int64_t now();
+    int64_t toTick(int64_t timeNs) const;
+    void schedule(int clientId, Session& session, int64_t deadlineTick);
+    void rebuildWheel();
+
+    mutable std::mutex _mutex;
+    std::unordered_map<int, Session> _sessions;
+    std::vector<std::vector<int>> _wheel;                 // Each slot holds the clients due in that slot
+    int64_t _currentTick;                                 // Last tick processed by collectExpired
+
+    int64_t _timeoutNs;
+    int64_t _slotDurationNs;
+};
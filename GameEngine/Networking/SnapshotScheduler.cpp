@@ -0,0 +1,147 @@
+#include "SnapshotScheduler.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const float MOVING_PRIORITY = 1.0f;                   // Added for entities with a velocity
+static const float NEARBY_PRIORITY = 8.0f;                   // Added for entities at the player, halved at NEARBY_DISTANCE
+static const float NEARBY_DISTANCE = 400.0f;
+static const double SLOW_DOWN = 1.25;                        // Interval factors when the world does not fit / fits easily
+static const double SPEED_UP = 0.9;
+static const double HEADROOM = 1.5;                          // A snapshot budget this many times the full world speeds up
+
+// How much an entity matters to a client, per second
+static float priorityOf(const Entity& entity, const Entity* player) {
+    float priority = 1.0f;
+    if (entity.getVelocityX() != 0 || entity.getVelocityY() != 0) priority += MOVING_PRIORITY;
+    if (player) {
+        float dx = entity.getOriginalPosition().x - player->getOriginalPosition().x;
+        float dy = entity.getOriginalPosition().y - player->getOriginalPosition().y;
+        priority += NEARBY_PRIORITY * NEARBY_DISTANCE / (NEARBY_DISTANCE + std::sqrt(dx * dx + dy * dy));
+    }
+    return priority;
+}
+
+SnapshotScheduler::Clock::duration SnapshotScheduler::intervalOf(int snapshotsPerSecond) const {
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(1, snapshotsPerSecond)));
+}
+
+void SnapshotScheduler::setSnapshotRate(int snapshotsPerSecond) {
+    _snapshotRate = std::max(1, snapshotsPerSecond);
+    _minSnapshotRate = std::min(_minSnapshotRate, _snapshotRate);
+    for (auto& [clientId, client] : _clients) client.interval = intervalOf(_snapshotRate);
+}
+
+int SnapshotScheduler::getSnapshotRate() const { return _snapshotRate; }
+
+void SnapshotScheduler::setMinSnapshotRate(int snapshotsPerSecond) {
+    _minSnapshotRate = std::max(1, std::min(snapshotsPerSecond, _snapshotRate));
+}
+
+void SnapshotScheduler::setDefaultBandwidth(int64_t bytesPerSecond) { _defaultBandwidth = std::max<int64_t>(0, bytesPerSecond); }
+
+void SnapshotScheduler::addClient(int clientId, int64_t bandwidth) {
+    ClientState& client = _clients[clientId];
+    client.bandwidth = bandwidth > 0 ? bandwidth : _defaultBandwidth;
+    client.interval = intervalOf(_snapshotRate);
+    client.nextSnapshot = Clock::now();
+    client.lastSnapshot = client.nextSnapshot - client.interval;
+    client.lastCredited = client.lastSnapshot;
+    client.credit = 0;
+    client.priorities.clear();
+}
+
+void SnapshotScheduler::removeClient(int clientId) {
+    _clients.erase(clientId);
+}
+
+bool SnapshotScheduler::schedule(int clientId, const Entity* player, const std::vector<Entity*>& entities, Clock::time_point now, std::vector<Entity*>& selected) {
+    PROFILE_ZONE("SnapshotScheduler::schedule");
+    selected.clear();
+    auto it = _clients.find(clientId);
+    if (it == _clients.end() || now < it->second.nextSnapshot) return false;
+
+    ClientState& client = it->second;
+    client.nextSnapshot += client.interval;
+    if (client.nextSnapshot < now) client.nextSnapshot = now + client.interval;
+
+    if (client.bandwidth == 0) {
+        client.lastSnapshot = now;
+        selected = entities;
+        return true;
+    }
+
+    // Bytes build up at the budget's rate; an idle client can save up for at most one snapshot at the minimum rate,
+    // but always for one with its own entity, so that small budgets get slow snapshots rather than none
+    double maxCredit = std::max(static_cast<double>(client.bandwidth) / _minSnapshotRate, _bytesPerSnapshot + _bytesPerEntity);
+    double creditElapsed = std::min(1.0, std::chrono::duration<double>(now - client.lastCredited).count());
+    client.lastCredited = now;
+    client.credit = std::min(client.credit + client.bandwidth * creditElapsed, maxCredit);
+
+    // Adapt the rate to what one snapshot can carry at the current rate
+    double intervalSeconds = std::chrono::duration<double>(client.interval).count();
+    double snapshotBudget = client.bandwidth * intervalSeconds;
+    double fullSnapshot = _bytesPerSnapshot + entities.size() * _bytesPerEntity;
+    if (snapshotBudget < fullSnapshot) {
+        client.interval = std::min(intervalOf(_minSnapshotRate), std::chrono::duration_cast<Clock::duration>(client.interval * SLOW_DOWN));
+    }
+    else if (snapshotBudget > fullSnapshot * HEADROOM) {
+        client.interval = std::max(intervalOf(_snapshotRate), std::chrono::duration_cast<Clock::duration>(client.interval * SPEED_UP));
+    }
+
+    size_t capacity = client.credit > _bytesPerSnapshot ? static_cast<size_t>((client.credit - _bytesPerSnapshot) / _bytesPerEntity) : 0;
+    if (capacity == 0) return false;
+
+    // Skipped snapshots keep their time, so priorities keep building up while the budget is short
+    double elapsed = std::min(1.0, std::chrono::duration<double>(now - client.lastSnapshot).count());
+    client.lastSnapshot = now;
+
+    // The client's own entity always goes first. The others gain priority for the time since the last
+    // snapshot, and the most important ones fill the rest of the budget.
+    _candidates.clear();
+    for (Entity* entity : entities) {
+        if (entity == player) {
+            selected.push_back(entity);
+            capacity--;
+            continue;
+        }
+        float& priority = client.priorities[entity->getEntityID()];
+        priority += priorityOf(*entity, player) * static_cast<float>(elapsed);
+        _candidates.emplace_back(priority, entity);
+    }
+    if (client.priorities.size() > entities.size() * 2) {
+        // Forget entities that no longer exist
+        client.priorities.clear();
+        for (const auto& [priority, entity] : _candidates) client.priorities[entity->getEntityID()] = priority;
+    }
+
+    if (capacity < _candidates.size()) {
+        std::nth_element(_candidates.begin(), _candidates.begin() + capacity, _candidates.end(),
+            [](const std::pair<float, Entity*>& a, const std::pair<float, Entity*>& b) { return a.first > b.first; });
+        _candidates.resize(capacity);
+    }
+
+    for (const auto& [priority, entity] : _candidates) {
+        selected.push_back(entity);
+        client.priorities[entity->getEntityID()] = 0;
+    }
+    return true;
+}
+
+void SnapshotScheduler::recordSent(int clientId, size_t bytes, size_t entityCount) {
+    auto it = _clients.find(clientId);
+    if (it == _clients.end()) return;
+
+    it->second.credit -= static_cast<double>(bytes);
+    if (entityCount > 0 && bytes > _bytesPerSnapshot) {
+        // Moving average, so the estimate follows the actual messages
+        _bytesPerEntity += 0.1 * ((bytes - _bytesPerSnapshot) / entityCount - _bytesPerEntity);
+    }
+}
+
+double SnapshotScheduler::getClientRate(int clientId) const {
+    auto it = _clients.find(clientId);
+    if (it == _clients.end()) return 0;
+    return 1.0 / std::chrono::duration<double>(it->second.interval).count();
+}
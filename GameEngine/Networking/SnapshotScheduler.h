@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Entity.h"
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Decides when each client gets a snapshot and which entities it carries. The snapshot rate is independent
+// of the simulation rate, and every client has its own rate and bandwidth budget (bytes per second).
+//
+// The client's own entity is in every snapshot. The other entities compete for the rest of the budget through
+// a priority accumulator: before every snapshot each entity gains priority by how much it matters to that client
+// (entities near its player most, moving entities more than still ones), and the entities with the most priority
+// are sent until the budget is spent. A sent entity starts over at zero, so far away entities still go out,
+// just less often. When the budget cannot fit the whole world, the client's rate drops towards the minimum
+// rate so each snapshot can carry more; it recovers once the world fits again.
+class SnapshotScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Highest snapshot rate of a client (snapshots per second)
+    void setSnapshotRate(int snapshotsPerSecond);
+    int getSnapshotRate() const;
+    // Lowest rate a client drops to when its budget is tight
+    void setMinSnapshotRate(int snapshotsPerSecond);
+    // Budget of clients that did not ask for one. 0 means unlimited.
+    void setDefaultBandwidth(int64_t bytesPerSecond);
+
+    // 'bandwidth' is the client's own budget in bytes per second, or 0 for the default
+    void addClient(int clientId, int64_t bandwidth = 0);
+    void removeClient(int clientId);
+
+    // Fills 'selected' with the entities to send to a client now, or returns false if the client has no
+    // snapshot due. 'player' is the client's own entity, if any.
+    bool schedule(int clientId, const Entity* player, const std::vector<Entity*>& entities, Clock::time_point now, std::vector<Entity*>& selected);
+    // Charges the size of the snapshot built from the last schedule() to the client's budget
+    void recordSent(int clientId, size_t bytes, size_t entityCount);
+
+    // Current snapshot rate of a client, or 0 if it is unknown
+    double getClientRate(int clientId) const;
+
+private:
+    struct ClientState {
+        int64_t bandwidth = 0;                               // Bytes per second, 0 for unlimited
+        Clock::duration interval{};                          // Time between snapshots at the current rate
+        Clock::time_point nextSnapshot{};
+        Clock::time_point lastSnapshot{};                    // Priorities have built up since then
+        Clock::time_point lastCredited{};                    // Credit has built up since then
+        double credit = 0;                                   // Bytes the client may receive right now
+        std::unordered_map<int, float> priorities;           // Accumulated priority by entity ID
+    };
+
+    int _snapshotRate = 60;
+    int _minSnapshotRate = 10;
+    int64_t _defaultBandwidth = 0;
+    double _bytesPerEntity = 250;                            // Average size of an entity in a snapshot, measured
+    double _bytesPerSnapshot = 80;                           // Size of a snapshot without entities
+    std::unordered_map<int, ClientState> _clients;
+    std::vector<std::pair<float, Entity*>> _candidates;      // Scratch buffer, reused for every snapshot
+
+    Clock::duration intervalOf(int snapshotsPerSecond) const;
+};
@@ -0,0 +1,270 @@
+#include "WorldBlob.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char MAGIC[4] = { 'W', 'B', 'L', 'B' };
+static const size_t HEADER_SIZE = 4 + 2 + 4 + 8;
+
+template <typename T>
+static void write(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Bounds-checked sequential reads from a buffer
+struct Reader {
+    const char* data;
+    size_t size;
+    size_t offset = 0;
+    bool failed = false;
+
+    template <typename T>
+    T read() {
+        T value{};
+        if (failed || size - offset < sizeof(T)) {
+            failed = true;
+            return value;
+        }
+        memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    const char* skip(size_t length) {
+        if (failed || size - offset < length) {
+            failed = true;
+            return nullptr;
+        }
+        const char* start = data + offset;
+        offset += length;
+        return start;
+    }
+};
+
+uint64_t WorldBlob::fnv1a(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string WorldBlob::encode(const std::vector<const Entity*>& entities) {
+    PROFILE_ZONE("WorldBlob::encode");
+    std::string records;
+    records.reserve(entities.size() * 64);
+
+    for (const Entity* entity : entities) {
+        SDL_Color color = entity->getColor();
+        const std::string& texturePath = entity->getTexturePath();
+
+        write<int32_t>(records, entity->getEntityID());
+        write<float>(records, entity->getOriginalPosition().x);
+        write<float>(records, entity->getOriginalPosition().y);
+        write<float>(records, entity->getSize().width);
+        write<float>(records, entity->getSize().height);
+        write<uint8_t>(records, static_cast<uint8_t>(entity->getEntityType()));
+        write<uint8_t>(records, static_cast<uint8_t>(entity->getZoneType()));
+        write<float>(records, entity->getVelocityX());
+        write<float>(records, entity->getVelocityY());
+        write<float>(records, entity->getAccelerationX());
+        write<float>(records, entity->getAccelerationY());
+        write<float>(records, entity->getRotationAngle());
+        write<uint8_t>(records, color.r);
+        write<uint8_t>(records, color.g);
+        write<uint8_t>(records, color.b);
+        write<uint8_t>(records, color.a);
+        // The length prefix is 16 bits, so longer paths are cut to fit it
+        uint16_t texturePathLength = static_cast<uint16_t>(std::min<size_t>(texturePath.size(), UINT16_MAX));
+        write<uint16_t>(records, texturePathLength);
+        records.append(texturePath, 0, texturePathLength);
+    }
+
+    std::string blob;
+    blob.reserve(HEADER_SIZE + records.size());
+    blob.append(MAGIC, sizeof(MAGIC));
+    write<uint16_t>(blob, VERSION);
+    write<uint32_t>(blob, static_cast<uint32_t>(entities.size()));
+    write<uint64_t>(blob, fnv1a(records.data(), records.size()));
+    blob += records;
+    return blob;
+}
+
+bool WorldBlob::decode(const char* data, size_t size, std::vector<Entity*>& entities) {
+    PROFILE_ZONE("WorldBlob::decode");
+    Reader reader{ data, size };
+    const char* magic = reader.skip(sizeof(MAGIC));
+    if (!magic || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (reader.read<uint16_t>() != VERSION) return false;
+
+    uint32_t count = reader.read<uint32_t>();
+    uint64_t hash = reader.read<uint64_t>();
+    if (reader.failed || fnv1a(data + reader.offset, size - reader.offset) != hash) return false;
+
+    size_t firstNew = entities.size();
+    entities.reserve(firstNew + count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t id = reader.read<int32_t>();
+        float x = reader.read<float>();
+        float y = reader.read<float>();
+        float width = reader.read<float>();
+        float height = reader.read<float>();
+        uint8_t entityType = reader.read<uint8_t>();
+        uint8_t zoneType = reader.read<uint8_t>();
+        float velocityX = reader.read<float>();
+        float velocityY = reader.read<float>();
+        float accelerationX = reader.read<float>();
+        float accelerationY = reader.read<float>();
+        float rotationAngle = reader.read<float>();
+        SDL_Color color;
+        color.r = reader.read<uint8_t>();
+        color.g = reader.read<uint8_t>();
+        color.b = reader.read<uint8_t>();
+        color.a = reader.read<uint8_t>();
+        uint16_t texturePathLength = reader.read<uint16_t>();
+        const char* texturePath = reader.skip(texturePathLength);
+
+        if (reader.failed) {
+            for (size_t j = firstNew; j < entities.size(); j++) delete entities[j];
+            entities.resize(firstNew);
+            return false;
+        }
+
+        Entity* entity = new Entity(Position(x, y), Size(width, height));
+        entity->setEntityID(id);
+        entity->setEntityType(static_cast<EntityType>(entityType));
+        entity->setZoneType(static_cast<ZoneType>(zoneType));
+        entity->setVelocityX(velocityX);
+        entity->setVelocityY(velocityY);
+        entity->setAccelerationX(accelerationX);
+        entity->setAccelerationY(accelerationY);
+        entity->setColor(color);
+        entity->setRotationAngle(rotationAngle);
+        entity->setTexturePath(std::string(texturePath, texturePathLength));
+        entities.push_back(entity);
+    }
+    return true;
+}
+
+uint64_t WorldBlob::hashOf(const std::string& blob) {
+    if (blob.size() < HEADER_SIZE || memcmp(blob.data(), MAGIC, sizeof(MAGIC)) != 0) return 0;
+    uint64_t hash;
+    memcpy(&hash, blob.data() + HEADER_SIZE - sizeof(hash), sizeof(hash));
+    return hash;
+}
+
+bool WorldBlob::verify(const std::string& blob) {
+    if (blob.size() < HEADER_SIZE || memcmp(blob.data(), MAGIC, sizeof(MAGIC)) != 0) return false;
+
+    uint16_t version;
+    memcpy(&version, blob.data() + sizeof(MAGIC), sizeof(version));
+    return version == VERSION && fnv1a(blob.data() + HEADER_SIZE, blob.size() - HEADER_SIZE) == hashOf(blob);
+}
+
+std::string WorldBlob::formatConnectRequest(int roomId, uint64_t cachedHash, int64_t bandwidth) {
+    std::string request = "CONNECT";
+    if (roomId < 0 && cachedHash == 0 && bandwidth <= 0) return request;
+
+    request += "|" + (roomId >= 0 ? std::to_string(roomId) : std::string());
+    if (cachedHash == 0 && bandwidth <= 0) return request;
+
+    request += "|";
+    if (cachedHash != 0) {
+        char hex[17];
+        snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(cachedHash));
+        request += hex;
+    }
+    if (bandwidth > 0) request += "|" + std::to_string(bandwidth);
+    return request;
+}
+
+// Start of the given '|' separated field of a connect request, or npos
+static size_t fieldOffset(const std::string& request, int field) {
+    size_t offset = 0;
+    for (int i = 0; i < field; i++) {
+        offset = request.find('|', offset);
+        if (offset == std::string::npos) return offset;
+        offset++;
+    }
+    return offset;
+}
+
+uint64_t WorldBlob::parseCachedHash(const std::string& request) {
+    size_t offset = fieldOffset(request, 2);
+    if (offset == std::string::npos) return 0;
+    return std::strtoull(request.c_str() + offset, nullptr, 16);
+}
+
+int64_t WorldBlob::parseBandwidth(const std::string& request) {
+    size_t offset = fieldOffset(request, 3);
+    if (offset == std::string::npos) return 0;
+    return std::strtoll(request.c_str() + offset, nullptr, 10);
+}
+
+std::string WorldBlob::buildHandshake(const std::vector<Entity*>& entities, const std::vector<Entity*>& physicsEntities, uint64_t cachedHash) {
+    PROFILE_ZONE("WorldBlob::buildHandshake");
+    if (!_valid) {
+        std::unordered_set<const Entity*> simulated(physicsEntities.begin(), physicsEntities.end());
+        std::vector<const Entity*> staticEntities;
+        _staticEntities.clear();
+        for (const Entity* entity : entities) {
+            if (simulated.count(entity)) continue;
+            staticEntities.push_back(entity);
+            _staticEntities.insert(entity);
+        }
+
+        _staticBlob = encode(staticEntities);
+        _staticHash = hashOf(_staticBlob);
+        _valid = true;
+    }
+
+    std::vector<const Entity*> dynamicEntities;
+    for (const Entity* entity : entities) {
+        if (!_staticEntities.count(entity)) dynamicEntities.push_back(entity);
+    }
+    std::string dynamicBlob = encode(dynamicEntities);
+
+    std::string body;
+    bool includeStatic = cachedHash == 0 || cachedHash != _staticHash;
+    write<uint8_t>(body, includeStatic ? 1 : 0);
+    if (includeStatic) {
+        write<uint32_t>(body, static_cast<uint32_t>(_staticBlob.size()));
+        body += _staticBlob;
+    }
+    else {
+        write<uint64_t>(body, _staticHash);
+    }
+    write<uint32_t>(body, static_cast<uint32_t>(dynamicBlob.size()));
+    body += dynamicBlob;
+    return body;
+}
+
+void WorldBlob::invalidate() {
+    _valid = false;
+}
+
+bool WorldBlob::parseHandshake(const char* data, size_t size, std::string& staticBlob, uint64_t& staticHash, std::string& dynamicBlob) {
+    Reader reader{ data, size };
+    staticBlob.clear();
+
+    if (reader.read<uint8_t>() == 1) {
+        uint32_t length = reader.read<uint32_t>();
+        const char* blob = reader.skip(length);
+        if (blob) staticBlob.assign(blob, length);
+        staticHash = hashOf(staticBlob);
+    }
+    else {
+        staticHash = reader.read<uint64_t>();
+    }
+
+    uint32_t length = reader.read<uint32_t>();
+    const char* blob = reader.skip(length);
+    if (reader.failed) return false;
+    dynamicBlob.assign(blob, length);
+    return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Entity.h"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Binary handshake payload. The static world (entities not simulated by physics) is encoded once into a
+// versioned, content-hashed blob that is sent as-is, or skipped when the client already has it cached.
+// Entities that move are encoded into a small dynamic blob on every connect.
+//
+// Blob layout (little endian):
+//   "WBLB" | u16 version | u32 entity count | u64 FNV-1a hash of the records | records
+//   record: i32 id | f32 x, y, width, height | u8 type, zone type | f32 velocity x, y, acceleration x, y,
+//           rotation | u8 r, g, b, a | u16 texture path length | texture path
+// Handshake body (after "clientID|entityID|"):
+//   u8 static included | (u32 length | static blob) or (u64 static hash) | u32 length | dynamic blob
+class WorldBlob {
+public:
+    static constexpr uint16_t VERSION = 1;
+
+    static std::string encode(const std::vector<const Entity*>& entities);
+    // Decodes the entities of a blob in one pass and appends them to 'entities'. Returns false if the blob
+    // is truncated, has another version or does not match its hash; nothing is appended in that case.
+    static bool decode(const char* data, size_t size, std::vector<Entity*>& entities);
+    // Hash stored in a blob's header, or 0 if it is not a blob
+    static uint64_t hashOf(const std::string& blob);
+    // Checks the header and the hash without decoding, e.g. for blobs loaded from a cache
+    static bool verify(const std::string& blob);
+    static uint64_t fnv1a(const char* data, size_t size);
+
+    // "CONNECT|<room>|<hash>|<bandwidth>" request with the room to join (-1 for a plain Server), the hash of the
+    // cached static world (0 if none) and the snapshot bandwidth the client asks for (bytes per second, 0 for the
+    // server's default). Trailing empty fields are left out.
+    static std::string formatConnectRequest(int roomId, uint64_t cachedHash, int64_t bandwidth = 0);
+    // Hash of the static world the client has cached, or 0 if the request carries none
+    static uint64_t parseCachedHash(const std::string& request);
+    // Snapshot bandwidth the client asks for, or 0 if the request carries none
+    static int64_t parseBandwidth(const std::string& request);
+
+    // Builds the handshake body for the given world. The static blob is built on first use.
+    std::string buildHandshake(const std::vector<Entity*>& entities, const std::vector<Entity*>& physicsEntities, uint64_t cachedHash);
+    // Rebuilds the static blob on the next handshake. Call when static entities are added, removed or changed.
+    void invalidate();
+
+    // Splits a handshake body into the static and dynamic blobs. If the static world was skipped, 'staticBlob'
+    // is left empty and 'staticHash' names the cached blob to use. Returns false if the body is malformed.
+    static bool parseHandshake(const char* data, size_t size, std::string& staticBlob, uint64_t& staticHash, std::string& dynamicBlob);
+
+private:
+    bool _valid = false;
+    std::string _staticBlob;
+    uint64_t _staticHash = 0;
+    std::unordered_set<const Entity*> _staticEntities;
+};
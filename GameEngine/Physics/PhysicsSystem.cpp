@@ -1,8 +1,16 @@
 #include "PhysicsSystem.h"
+#include "CollisionSystem.h"
+#include "StaticIndex.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const float CONTACT_DEPTH = 1.0f;                 // How far a swept entity ends up inside what it hit
 
 // Initializes class variables
 bool PhysicsSystem::initialize() {	
-	_entities.clear();	
+	clearEntities();
 	return true;
 }
 
@@ -12,47 +20,125 @@ void PhysicsSystem::applyPhysics(Entity& entity, float gravity, Velocity velocit
 	entity.setVelocityY(velocity.y);
 	entity.setAccelerationX(acceleration.x);
 	entity.setAccelerationY(acceleration.y + gravity);
-	
-	// Add the entity to the list if it's not already there
-	if (std::find(_entities.begin(), _entities.end(), &entity) == _entities.end()) {
-		_entities.push_back(&entity);
-	}
+	entity.setStatic(false);                                    // Simulated entities move, whatever their type
+	addEntity(entity);
+}
+
+// Every registered entity knows its slot in the list, which doubles as its membership flag
+void PhysicsSystem::addEntity(Entity& entity) {
+    if (contains(entity)) return;
+
+    entity.setPhysicsSlot(static_cast<int>(_entities.size()));
+    _entities.push_back(&entity);
+}
+
+void PhysicsSystem::removeEntity(Entity& entity) {
+    if (!contains(entity)) return;
+
+    int slot = entity.getPhysicsSlot();
+    _entities[slot] = _entities.back();
+    _entities[slot]->setPhysicsSlot(slot);
+    _entities.pop_back();
+    entity.setPhysicsSlot(-1);
+}
+
+// Slots are checked against the list, since a world simulated by another system may have set them
+bool PhysicsSystem::contains(const Entity& entity) const {
+    int slot = entity.getPhysicsSlot();
+    return slot >= 0 && slot < static_cast<int>(_entities.size()) && _entities[slot] == &entity;
 }
 
 // Similates the physics system. All entities included in the _entities array will experience physics.
-void PhysicsSystem::run(float deltaTime, std::set<Entity*>& entitiesToIgnore) {
+void PhysicsSystem::run(float deltaTime, ThreadPool* threadPool) {
+    PROFILE_ZONE("PhysicsSystem::run");
     if (_isPaused) return;
 
-    for (Entity* entity : _entities) {
-        if (entitiesToIgnore.find(entity) == entitiesToIgnore.end()) {
-            // Updating velocity with acceleration (v = u + at)
-            entity->setVelocityX(entity->getVelocityX() + entity->getAccelerationX() * deltaTime);
-            entity->setVelocityY(entity->getVelocityY() + entity->getAccelerationY() * deltaTime);
-
-            // Updating position with velocity (s = s0 + vt)
-            entity->setOriginalPosition(Position(
-                entity->getOriginalPosition().x + entity->getVelocityX() * deltaTime,
-                entity->getOriginalPosition().y + entity->getVelocityY() * deltaTime
-            ));
-        }
+    if (!threadPool) {
+        _asleepCount = runRange(deltaTime, 0, _entities.size());
+        return;
     }
+
+    std::atomic<size_t> asleepCount{ 0 };
+    size_t chunkCount = static_cast<size_t>(threadPool->getThreadCount()) * 4;
+    size_t chunkSize = (_entities.size() + chunkCount - 1) / chunkCount;
+    threadPool->parallelFor(chunkCount, [this, deltaTime, chunkSize, &asleepCount](size_t chunk, size_t) {
+        PROFILE_ZONE("PhysicsSystem::runRange");
+        asleepCount += runRange(deltaTime, chunk * chunkSize, (chunk + 1) * chunkSize);
+        });
+    _asleepCount = asleepCount.load();
 }
 
-void PhysicsSystem::runForGivenEntities(float deltaTime, std::set<Entity*>& entitiesToIgnore, const std::vector<Entity*>& entities) {
+// Counting the sleepers here keeps the count free for the metrics
+size_t PhysicsSystem::runRange(float deltaTime, size_t begin, size_t end) {
+    size_t asleepCount = 0;
+    for (size_t i = begin; i < end && i < _entities.size(); i++) {
+        Entity* entity = _entities[i];
+        if (!entity->isAsleep()) simulate(entity, deltaTime, entity->isColliding());
+        if (entity->isAsleep()) asleepCount++;
+    }
+    return asleepCount;
+}
+
+// Entities resting against something are left out of integration by the collision, and the contact holds them
+// against their acceleration, so they can fall asleep while gravity still pulls on them
+void PhysicsSystem::simulate(Entity* entity, float deltaTime, bool collided) {
+    if (!collided) {
+        // Updating velocity with acceleration (v = u + at)
+        entity->setVelocityX(entity->getVelocityX() + entity->getAccelerationX() * deltaTime);
+        entity->setVelocityY(entity->getVelocityY() + entity->getAccelerationY() * deltaTime);
+
+        // Updating position with velocity (s = s0 + vt)
+        float dx = entity->getVelocityX() * deltaTime;
+        float dy = entity->getVelocityY() * deltaTime;
+        if (_staticIndex) sweep(*entity, dx, dy);
+        entity->setOriginalPosition(Position(entity->getOriginalPosition().x + dx, entity->getOriginalPosition().y + dy));
+    }
+
+    if (_sleepVelocity >= 0) entity->rest(_sleepVelocity, _sleepTicks, collided);
+}
+
+// An entity that moves no further than its own size overlaps anything it passes at the start or the end of the
+// step, so only faster ones need the swept test. The hit entity is entered by CONTACT_DEPTH along the axis it
+// was hit on, which the integer rectangles of the discrete test still see as an overlap.
+void PhysicsSystem::sweep(const Entity& entity, float& dx, float& dy) const {
+    CollisionSystem::Shape shape = CollisionSystem::shapeOf(entity);
+    if (std::abs(dx) <= shape.maxX - shape.minX && std::abs(dy) <= shape.maxY - shape.minY) return;
+    if (entity.getEntityType() == EntityType::GHOST || shape.type == ShapeType::NONE) return;
+    // Entities moving away from a collision pass through entities at rest (see CollisionSystem::hasCollision)
+    if (entity.getAccelerationX() * entity.getVelocityX() < 0 || entity.getAccelerationY() * entity.getVelocityY() < 0) return;
+
+    static thread_local std::vector<Entity*> nearby;
+    _staticIndex->query(std::min(shape.minX, shape.minX + dx), std::min(shape.minY, shape.minY + dy),
+        std::max(shape.maxX, shape.maxX + dx), std::max(shape.maxY, shape.maxY + dy), nearby);
+
+    CollisionSystem::Impact first;
+    for (const Entity* obstacle : nearby) {
+        CollisionSystem::Impact impact = CollisionSystem::sweep(entity, dx, dy, *obstacle);
+        if (impact.time < first.time) first = impact;
+    }
+    if (first.time > 1.0f) return;
+
+    float time = std::min(1.0f, first.time + CONTACT_DEPTH / std::abs(first.xAxis ? dx : dy));
+    dx *= time;
+    dy *= time;
+}
+
+void PhysicsSystem::runForGivenEntities(float deltaTime, const std::vector<Entity*>& entities) {
+    runForGivenEntities(deltaTime, entities.data(), entities.size());
+}
+
+void PhysicsSystem::runForGivenEntities(float deltaTime, const FrameVector<Entity*>& entities) {
+    runForGivenEntities(deltaTime, entities.data(), entities.size());
+}
+
+void PhysicsSystem::runForGivenEntities(float deltaTime, Entity* const* entities, size_t count) {
+    PROFILE_ZONE("PhysicsSystem::runForGivenEntities");
     if (_isPaused) return;
 
-    for (Entity* entity : entities) {
-        if (entitiesToIgnore.find(entity) == entitiesToIgnore.end()) {
-            // Updating velocity with acceleration (v = u + at)
-            entity->setVelocityX(entity->getVelocityX() + entity->getAccelerationX() * deltaTime);
-            entity->setVelocityY(entity->getVelocityY() + entity->getAccelerationY() * deltaTime);
-
-            // Updating position with velocity (s = s0 + vt)
-            entity->setOriginalPosition(Position(
-                entity->getOriginalPosition().x + entity->getVelocityX() * deltaTime,
-                entity->getOriginalPosition().y + entity->getVelocityY() * deltaTime
-            ));
-        }
+    for (size_t i = 0; i < count; i++) {
+        Entity* entity = entities[i];
+        if (entity->isStatic() || entity->isAsleep()) continue;
+        simulate(entity, deltaTime, entity->isColliding());
     }
 }
 
@@ -64,16 +150,45 @@ void PhysicsSystem::resume() {
     _isPaused = false;
 }
 
+void PhysicsSystem::setSleepThreshold(float velocityThreshold, int ticks) {
+    _sleepVelocity = velocityThreshold;
+    _sleepTicks = std::max(1, ticks);
+    if (velocityThreshold < 0) wakeAll();
+}
+
+void PhysicsSystem::wakeAll() {
+    for (Entity* entity : _entities) entity->wake();
+}
+
+size_t PhysicsSystem::getAsleepCount() const {
+    return _asleepCount;
+}
+
+size_t PhysicsSystem::getAwakeCount() const {
+    return _entities.size() - std::min(_entities.size(), getAsleepCount());
+}
+
+void PhysicsSystem::setStaticIndex(const StaticIndex* staticIndex) {
+    _staticIndex = staticIndex;
+}
+
 
 
 // Clears up the entities variable
 void PhysicsSystem::shutdown() {
+	clearEntities();
+}
+
+void PhysicsSystem::clearEntities() {
+	for (Entity* entity : _entities) entity->setPhysicsSlot(-1);
 	_entities.clear();
 }
 
 // Getter for the entities list
-std::vector<Entity*>& PhysicsSystem::getEntities() { return _entities; }
+const std::vector<Entity*>& PhysicsSystem::getEntities() const { return _entities; }
 
 void PhysicsSystem::setEntities(const std::vector<Entity*>& entities) {
-	_entities = entities;
+	clearEntities();
+	_entities.reserve(entities.size());
+	for (Entity* entity : entities) addEntity(*entity);
 }
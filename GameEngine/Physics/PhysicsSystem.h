@@ -1,14 +1,21 @@
 #pragma once
 
-#include <set>
-
 #include "Entity.h"
+#include "FrameArena.h"
+#include "ThreadPool.h"
+#include <atomic>
 #include <vector>
 
+class StaticIndex;
+
 // A singleton class that simulates a physics system. Currently handles 
-// gravity, horizontal movement, and vertical movement.
+// gravity, horizontal movement, and vertical movement. Worlds that are simulated
+// side by side in one process (see Room) create their own instances instead.
 class PhysicsSystem {
 public:
+	PhysicsSystem() = default;
+	~PhysicsSystem() = default;
+
 	static PhysicsSystem& getInstance() {
 		static PhysicsSystem instance;                    // Singleton variable
 		return instance;
@@ -20,27 +27,63 @@ public:
 	// Initializes class variables
 	bool initialize();
 
-	// Applies physical attributes to the entity that is passed in
+	// Applies physical attributes to the entity that is passed in and registers it. The entity becomes dynamic (see Entity::isStatic).
 	void applyPhysics(Entity& entity, float gravity = 9.8f, Velocity velocity = Velocity(), 
 		Acceleration acceleration = Acceleration());
 
-	// Simulates physics of the entire system
-	void run(float deltaTime, std::set<Entity*>& entitiesToIgnore);
+	// Simulates physics of the entire system. Entities that collided this tick (see Entity::isColliding) stay in place.
+	// With a thread pool, the entities are integrated in chunks on its threads, since each is updated independently.
+	void run(float deltaTime, ThreadPool* threadPool = nullptr);
 	void pause();
 	void resume();
 
-	void runForGivenEntities(float deltaTime, std::set<Entity*>& entitiesToIgnore, const std::vector<Entity *> &entities);
+	// Simulates the given entities instead of the registered ones. Static entities are skipped.
+	void runForGivenEntities(float deltaTime, const std::vector<Entity *> &entities);
+	void runForGivenEntities(float deltaTime, const FrameVector<Entity*>& entities);
+
+	// Entities that moved slower than 'velocityThreshold' for 'ticks' ticks in a row, without acceleration or while
+	// touching something, fall asleep (see Entity::rest). A threshold below 0 disables sleeping.
+	void setSleepThreshold(float velocityThreshold, int ticks);
+	// Wakes every simulated entity, e.g. after the static world changed under them
+	void wakeAll();
+	// Number of simulated entities that are asleep / awake, counted by the last run
+	size_t getAsleepCount() const;
+	size_t getAwakeCount() const;
+
+	// Entities that move further than their own size in one step are swept against the static entities of the index
+	// and stop just inside the first one in their way, so the next collision pass catches them instead of letting them
+	// tunnel through. The index must be up to date for the tick. nullptr disables the sweep.
+	void setStaticIndex(const StaticIndex* staticIndex);
 
 	// Shuts the physics engine down
 	void shutdown();
 
-	std::vector<Entity*>& getEntities();
+	// Registers an entity in constant time, unless it already is, without changing its motion
+	void addEntity(Entity& entity);
+	// Unregisters an entity in constant time. The last entity takes its place in the list.
+	void removeEntity(Entity& entity);
+	bool contains(const Entity& entity) const;
+
+	const std::vector<Entity*>& getEntities() const;
 	void setEntities(const std::vector<Entity *> &entities);
 
 private:
-	PhysicsSystem() = default;
-	~PhysicsSystem() = default;
-
 	std::vector<Entity*> _entities;
 	bool _isPaused = false;
+	float _sleepVelocity = 0.1f;
+	int _sleepTicks = 60;
+	const StaticIndex* _staticIndex = nullptr;
+	std::atomic<size_t> _asleepCount{ 0 };
+
+	// Simulates the entities in [begin, end) of the entity list and returns how many of them are asleep afterwards.
+	// Disjoint ranges can run on different threads.
+	size_t runRange(float deltaTime, size_t begin, size_t end);
+
+	// Integrates one entity unless it collided this tick, then updates its sleep state
+	void simulate(Entity* entity, float deltaTime, bool collided);
+	void runForGivenEntities(float deltaTime, Entity* const* entities, size_t count);
+	// Shortens the step (dx, dy) of an entity to the first static entity in its way
+	void sweep(const Entity& entity, float& dx, float& dy) const;
+	// Unregisters every entity
+	void clearEntities();
 };
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "Client.h"
+#include "EventManager.h"
+#include "Timeline.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One headless client session. Snapshots are decoded into entity update events like in the game client.
+struct Bot {
+	Client client;
+	Timeline timeline;
+	EventManager eventManager;
+
+	std::chrono::steady_clock::duration handshakeTime{};
+	std::vector<int64_t> latenciesUs;                                       // Age of every snapshot when it was decoded
+	std::vector<int64_t> inputRttsUs;                                       // Input to acknowledging snapshot, on the bot's own clock
+	uint64_t inputsSent = 0;
+	size_t scriptPosition = 0;
+
+	explicit Bot(zmq::context_t& context) : client(context), eventManager(&timeline) {
+		client.setVerbose(false);
+	}
+};
+
+static std::vector<std::string> parseScript(const std::string& script) {
+	std::vector<std::string> buttons;
+	std::stringstream stream(script);
+	std::string button;
+	while (std::getline(stream, button, ',')) {
+		if (!button.empty()) buttons.push_back(button);
+	}
+	return buttons;
+}
+
+static int64_t percentile(std::vector<int64_t>& sorted, double fraction) {
+	if (sorted.empty()) return -1;
+	return sorted[std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()))];
+}
+
+// Runs the frames of every 'threadCount'-th bot, starting at 'first', until the deadline
+static void runBots(std::vector<std::unique_ptr<Bot>>& bots, size_t first, size_t threadCount, double inputsPerSecond,
+	const std::vector<std::string>& script, std::chrono::steady_clock::time_point deadline) {
+	static const char* randomButtons[] = { "left", "right", "up", "down" };
+	const auto frame = std::chrono::microseconds(1000000 / 60);
+	const double inputChance = inputsPerSecond / 60.0;
+
+	std::mt19937 random(static_cast<unsigned>(first) + 1);
+	std::uniform_real_distribution<double> chance(0.0, 1.0);
+	auto nextFrame = std::chrono::steady_clock::now();
+
+	while (std::chrono::steady_clock::now() < deadline) {
+		for (size_t i = first; i < bots.size(); i += threadCount) {
+			Bot& bot = *bots[i];
+
+			// Drains every queued snapshot, so that a backlog shows up as latency rather than being hidden
+			uint64_t snapshots = bot.client.getSnapshotCount();
+			uint64_t acks = bot.client.getInputAckCount();
+			uint64_t received;
+			do {
+				received = bot.client.getBytesReceived();
+				bot.client.receiveEntityUpdatesFromServer(&bot.eventManager);
+				if (bot.client.getSnapshotCount() != snapshots) {
+					snapshots = bot.client.getSnapshotCount();
+					if (bot.client.getSnapshotLatencyUs() >= 0) bot.latenciesUs.push_back(bot.client.getSnapshotLatencyUs());
+				}
+				if (bot.client.getInputAckCount() != acks) {
+					acks = bot.client.getInputAckCount();
+					bot.inputRttsUs.push_back(bot.client.getInputRttUs());
+				}
+			} while (bot.client.getBytesReceived() != received);
+
+			bot.client.receiveMessagesFromServer();
+			bot.eventManager.process();
+
+			if (chance(random) < inputChance) {
+				if (script.empty()) {
+					bot.client.sendInputToServer(randomButtons[random() % 4]);
+				}
+				else {
+					bot.client.sendInputToServer(script[bot.scriptPosition++ % script.size()]);
+				}
+				bot.inputsSent++;
+			}
+			bot.client.sendHeartbeatToServer();
+		}
+
+		nextFrame += frame;
+		std::this_thread::sleep_until(nextFrame);
+	}
+}
+
+// Connects many headless clients to a running Server (or a room of a ServerHost) and reports what they observe.
+// Usage: BotSwarm [bots] [seconds] [threads] [inputs per second per bot] [host] [room] [script, e.g. left,left,up]
+int main(int argc, char** argv) {
+	int botCount = argc > 1 ? std::atoi(argv[1]) : 100;
+	int seconds = argc > 2 ? std::atoi(argv[2]) : 30;
+	int threadCount = std::max(1, argc > 3 ? std::atoi(argv[3]) : 4);
+	double inputsPerSecond = argc > 4 ? std::atof(argv[4]) : 5.0;
+	std::string host = argc > 5 ? argv[5] : "localhost";
+	int roomId = argc > 6 ? std::atoi(argv[6]) : -1;
+	std::vector<std::string> script = parseScript(argc > 7 ? argv[7] : "");
+
+	// A few I/O threads are enough for all sessions
+	zmq::context_t context(std::max(1, threadCount / 2));
+	std::vector<std::unique_ptr<Bot>> bots;
+
+	printf("Connecting %d bots to %s...\n", botCount, host.c_str());
+	for (int i = 0; i < botCount; i++) {
+		auto bot = std::make_unique<Bot>(context);
+		bot->client.setServerHost(host);
+		bot->client.setRoomID(roomId);
+		bot->client.initialize();
+
+		auto start = std::chrono::steady_clock::now();
+		if (!bot->client.handshakeWithServer()) {
+			printf("Bot %d failed to connect. Stopping at %d bots.\n", i, i);
+			break;
+		}
+		bot->handshakeTime = std::chrono::steady_clock::now() - start;
+		bots.push_back(std::move(bot));
+	}
+	if (bots.empty()) return 1;
+
+	printf("Running %d bots on %d threads for %d s at %.1f inputs/s each\n", static_cast<int>(bots.size()), threadCount, seconds, inputsPerSecond);
+	auto start = std::chrono::steady_clock::now();
+	auto deadline = start + std::chrono::seconds(seconds);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++) {
+		threads.emplace_back(runBots, std::ref(bots), static_cast<size_t>(t), static_cast<size_t>(threadCount), inputsPerSecond, std::cref(script), deadline);
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// Per-bot report for small swarms, distribution over all bots otherwise
+	std::vector<int64_t> allLatencies, allInputRtts;
+	std::vector<double> snapshotRates, receiveRates, sendRates;
+	double handshakeTotalMs = 0, handshakeMaxMs = 0;
+	uint64_t inputsSent = 0;
+
+	for (size_t i = 0; i < bots.size(); i++) {
+		Bot& bot = *bots[i];
+		double snapshotRate = bot.client.getSnapshotCount() / elapsed;
+		double receiveRate = bot.client.getBytesReceived() / elapsed / 1024;
+		double sendRate = bot.client.getBytesSent() / elapsed;
+		double handshakeMs = std::chrono::duration<double, std::milli>(bot.handshakeTime).count();
+
+		snapshotRates.push_back(snapshotRate);
+		receiveRates.push_back(receiveRate);
+		sendRates.push_back(sendRate);
+		handshakeTotalMs += handshakeMs;
+		handshakeMaxMs = std::max(handshakeMaxMs, handshakeMs);
+		inputsSent += bot.inputsSent;
+
+		std::sort(bot.latenciesUs.begin(), bot.latenciesUs.end());
+		std::sort(bot.inputRttsUs.begin(), bot.inputRttsUs.end());
+		if (bots.size() <= 20) {
+			printf("bot %3d (client %d): snapshots/s %6.1f   rx %8.1f KB/s   tx %7.1f B/s   latency p50 %6lld us   p99 %6lld us   input rtt p50 %6lld us   handshake %6.1f ms\n",
+				static_cast<int>(i), bot.client.getClientID(), snapshotRate, receiveRate, sendRate,
+				static_cast<long long>(percentile(bot.latenciesUs, 0.5)), static_cast<long long>(percentile(bot.latenciesUs, 0.99)),
+				static_cast<long long>(percentile(bot.inputRttsUs, 0.5)), handshakeMs);
+		}
+		allLatencies.insert(allLatencies.end(), bot.latenciesUs.begin(), bot.latenciesUs.end());
+		allInputRtts.insert(allInputRtts.end(), bot.inputRttsUs.begin(), bot.inputRttsUs.end());
+	}
+
+	std::sort(allLatencies.begin(), allLatencies.end());
+	std::sort(allInputRtts.begin(), allInputRtts.end());
+	std::sort(snapshotRates.begin(), snapshotRates.end());
+	std::sort(receiveRates.begin(), receiveRates.end());
+	std::sort(sendRates.begin(), sendRates.end());
+	size_t middle = bots.size() / 2;
+
+	printf("\n%d bots, %.1f s, %llu inputs sent\n", static_cast<int>(bots.size()), elapsed, static_cast<unsigned long long>(inputsSent));
+	printf("snapshots/s per bot  min %8.1f   p50 %8.1f   max %8.1f\n", snapshotRates.front(), snapshotRates[middle], snapshotRates.back());
+	printf("rx KB/s per bot      min %8.1f   p50 %8.1f   max %8.1f\n", receiveRates.front(), receiveRates[middle], receiveRates.back());
+	printf("tx B/s per bot       min %8.1f   p50 %8.1f   max %8.1f\n", sendRates.front(), sendRates[middle], sendRates.back());
+	// Snapshot age compares the server's wall clock with the bot's, so it includes any skew between the two machines.
+	// The input round trip is measured on the bot's clock alone, from sending an input to the first snapshot built after the server read it.
+	printf("snapshot latency     p50 %6lld us   p99 %6lld us   max %6lld us   (%d samples)\n",
+		static_cast<long long>(percentile(allLatencies, 0.5)), static_cast<long long>(percentile(allLatencies, 0.99)),
+		static_cast<long long>(allLatencies.empty() ? -1 : allLatencies.back()), static_cast<int>(allLatencies.size()));
+	printf("input round trip     p50 %6lld us   p99 %6lld us   max %6lld us   (%d samples)\n",
+		static_cast<long long>(percentile(allInputRtts, 0.5)), static_cast<long long>(percentile(allInputRtts, 0.99)),
+		static_cast<long long>(allInputRtts.empty() ? -1 : allInputRtts.back()), static_cast<int>(allInputRtts.size()));
+	printf("handshake            avg %6.1f ms   max %6.1f ms\n", handshakeTotalMs / bots.size(), handshakeMaxMs);
+
+	return 0;
+}
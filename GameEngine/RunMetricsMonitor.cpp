@@ -0,0 +1,70 @@
+#include "ServerMetrics.h"
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#ifdef __APPLE__
+#include <zmq.hpp>
+#else
+#include <ZMQ/zmq.hpp>
+#endif
+
+// Per-second rate of a cumulative counter between two metrics messages
+static double rate(const std::map<std::string, std::string>& current, const std::map<std::string, std::string>& previous,
+	const std::string& key, double seconds) {
+	auto now = current.find(key);
+	auto before = previous.find(key);
+	if (now == current.end() || before == previous.end() || seconds <= 0) return 0;
+	return (std::stod(now->second) - std::stod(before->second)) / seconds;
+}
+
+static std::string value(const std::map<std::string, std::string>& values, const std::string& key) {
+	auto it = values.find(key);
+	return it != values.end() ? it->second : "-";
+}
+
+// Attaches to a server's metrics port and prints live statistics.
+// Usage: MetricsMonitor [host] [port]
+int main(int argc, char** argv) {
+	std::string host = argc > 1 ? argv[1] : "localhost";
+	int port = argc > 2 ? std::atoi(argv[2]) : 5560;
+
+	zmq::context_t context(1);
+	zmq::socket_t subscriber(context, zmq::socket_type::sub);
+	subscriber.connect("tcp://" + host + ":" + std::to_string(port));
+	subscriber.set(zmq::sockopt::subscribe, "metrics");
+	printf("Listening for server metrics on %s:%d\n", host.c_str(), port);
+
+	std::map<std::string, std::string> values, previous;
+	while (true) {
+		zmq::message_t message;
+		if (!subscriber.recv(message, zmq::recv_flags::none)) continue;
+		if (!ServerMetrics::parse(std::string(static_cast<char*>(message.data()), message.size()), values)) continue;
+
+		double seconds = std::atof(value(values, "interval_ms").c_str()) / 1000.0;
+		double ticks = std::atof(value(values, "ticks").c_str());
+		const std::string histogram = value(values, "tick_hist");
+
+		printf("\n--- clients %s | entities %s (%s asleep) | event queue %s | heartbeat misses %s\n",
+			value(values, "clients").c_str(), value(values, "entities").c_str(), value(values, "asleep").c_str(),
+			value(values, "event_queue").c_str(), value(values, "hb_misses").c_str());
+		printf("ticks/s %8.1f   avg %6s us   p50 <%6.0f us   p99 <%6.0f us   max %6s us\n",
+			seconds > 0 ? ticks / seconds : 0, value(values, "tick_avg_us").c_str(),
+			ServerMetrics::histogramPercentile(histogram, 0.5), ServerMetrics::histogramPercentile(histogram, 0.99),
+			value(values, "tick_max_us").c_str());
+		printf("pairs/s %12.0f   events raised/s %8.0f   processed/s %8.0f\n",
+			rate(values, previous, "pairs", seconds), rate(values, previous, "events_raised", seconds),
+			rate(values, previous, "events_processed", seconds));
+		printf("rx %8.1f KB/s   tx %8.1f KB/s\n",
+			rate(values, previous, "rx", seconds) / 1024, rate(values, previous, "tx", seconds) / 1024);
+
+		for (const auto& [key, traffic] : values) {
+			if (key.rfind("client.", 0) != 0) continue;
+			printf("  client %-6s rx/tx bytes %s\n", key.c_str() + 7, traffic.c_str());
+		}
+
+		previous = values;
+	}
+
+	return 0;
+}
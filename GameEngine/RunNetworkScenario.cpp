@@ -0,0 +1,227 @@
+#include "GameEngine.h"
+#include "Entity.h"
+#include "Client.h"
+#include "EventManager.h"
+#include "NetworkEmulator.h"
+#include "Server.h"
+#include "Timeline.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// One step of the scenario: the link conditions of every client for a while
+struct Phase {
+	std::string name;
+	int seconds;
+	LinkConditions upstream;
+	LinkConditions downstream;
+};
+
+// A headless client behind its own emulated link
+struct EmulatedClient {
+	std::unique_ptr<NetworkEmulator> emulator;
+	std::unique_ptr<Client> client;
+	Timeline timeline;
+	EventManager eventManager{ &timeline };
+	std::vector<int64_t> latenciesUs;
+};
+
+// The RunServerHost world, with the obstacle last. Entities are never freed since the server runs until the process exits.
+static std::vector<Entity*> buildWorld() {
+	Entity* spawnPoint = new Entity(Position(0, 100), Size(200, 200));
+	spawnPoint->setEntityType(EntityType::GHOST);
+	spawnPoint->setZoneType(ZoneType::SPAWN);
+
+	Entity* deathZone = new Entity(Position(500, 500), Size(100, 100));
+	deathZone->setEntityType(EntityType::GHOST);
+	deathZone->setZoneType(ZoneType::DEATH);
+
+	Entity* platform = new Entity(Position(0, 600), Size(1920, 50));
+	Entity* obstacle = new Entity(Position(800, 100), Size(200, 200));
+	platform->setEntityType(EntityType::FIXED);
+
+	return { spawnPoint, deathZone, platform, obstacle };
+}
+
+// Default scenario: a perfect link, then increasingly bad ones
+static std::vector<Phase> defaultPhases(int seconds) {
+	const char* phases[][3] = {
+		{ "perfect", "-", "-" },
+		{ "broadband", "delay=15,jitter=3", "delay=15,jitter=3" },
+		{ "mobile", "delay=60,jitter=25,loss=0.02,reorder=0.01,bandwidth=32000", "delay=60,jitter=25,loss=0.02,reorder=0.01,bandwidth=256000" },
+		{ "congested", "delay=100,jitter=40,loss=0.05,bandwidth=16000", "delay=100,jitter=40,loss=0.05,bandwidth=64000,queue=60" },
+	};
+
+	std::vector<Phase> result;
+	for (const auto& phase : phases) {
+		Phase step;
+		step.name = phase[0];
+		step.seconds = seconds;
+		LinkConditions::parse(phase[1], step.upstream);
+		LinkConditions::parse(phase[2], step.downstream);
+		result.push_back(step);
+	}
+	return result;
+}
+
+// Scenario file: one phase per line, "<name> <seconds> <upstream conditions> <downstream conditions>".
+// Conditions use the LinkConditions::parse format, "-" for a perfect link. Lines starting with '#' are skipped.
+static bool loadPhases(const std::string& path, std::vector<Phase>& phases) {
+	std::ifstream file(path);
+	if (!file) return false;
+
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+
+		std::istringstream stream(line);
+		Phase phase;
+		std::string upstream, downstream;
+		if (!(stream >> phase.name >> phase.seconds >> upstream >> downstream)
+			|| !LinkConditions::parse(upstream, phase.upstream) || !LinkConditions::parse(downstream, phase.downstream)) {
+			printf("Invalid scenario line: %s\n", line.c_str());
+			return false;
+		}
+		phases.push_back(phase);
+	}
+	return !phases.empty();
+}
+
+static int64_t percentile(std::vector<int64_t>& values, double fraction) {
+	if (values.empty()) return -1;
+	std::sort(values.begin(), values.end());
+	return values[std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()))];
+}
+
+// Runs a Server and several headless clients, each behind its own emulated link, through a scripted
+// series of network conditions and reports what the clients observe in every phase. Loss, jitter and
+// reordering are seeded, so runs are reproducible.
+// Usage: NetworkScenario [clients] [seconds per phase] [scenario file]
+int main(int argc, char** argv) {
+	int clientCount = argc > 1 ? std::atoi(argv[1]) : 4;
+	int seconds = argc > 2 ? std::atoi(argv[2]) : 10;
+
+	std::vector<Phase> phases;
+	if (argc > 3) {
+		if (!loadPhases(argv[3], phases)) {
+			printf("Could not load scenario %s\n", argv[3]);
+			return 1;
+		}
+	}
+	else {
+		phases = defaultPhases(seconds);
+	}
+
+	// The server runs on the default ports for the lifetime of the process
+	std::vector<Entity*> world = buildWorld();
+	Server* server = new Server(world);
+	server->getGameEngine()->getPhysicsSystem()->applyPhysics(*world.back(), 0);
+	server->initialize();
+	std::thread([server]() { server->run(); }).detach();
+
+	zmq::context_t context(1);
+	std::vector<std::unique_ptr<EmulatedClient>> clients;
+	for (int i = 0; i < clientCount; i++) {
+		auto emulated = std::make_unique<EmulatedClient>();
+		int basePort = 6000 + i * 10;
+
+		emulated->emulator = std::make_unique<NetworkEmulator>(context, static_cast<unsigned>(i) + 1);
+		emulated->emulator->addServerChannels(basePort);
+		emulated->emulator->start();
+
+		emulated->client = std::make_unique<Client>(context);
+		emulated->client->setVerbose(false);
+		emulated->client->initialize(basePort + 1, basePort, basePort + 2, basePort + 3, basePort + 4);
+		if (!emulated->client->handshakeWithServer()) {
+			printf("Client %d failed to connect.\n", i);
+			return 1;
+		}
+
+		clients.push_back(std::move(emulated));
+	}
+
+	static const char* inputs[] = { "left", "up", "right", "up" };
+	const auto frame = std::chrono::microseconds(1000000 / 60);
+
+	printf("%-10s %12s %12s %12s %10s %10s %10s %10s\n", "phase", "snapshots/s", "latency p50", "latency p99", "rx KB/s", "dropped", "reordered", "delivered");
+	for (const Phase& phase : phases) {
+		std::vector<uint64_t> snapshotsBefore, bytesBefore;
+		NetworkEmulator::LinkStats statsBefore[2] = {};
+		for (auto& emulated : clients) {
+			emulated->emulator->setConditions(NetworkEmulator::Direction::Upstream, phase.upstream);
+			emulated->emulator->setConditions(NetworkEmulator::Direction::Downstream, phase.downstream);
+			emulated->latenciesUs.clear();
+			snapshotsBefore.push_back(emulated->client->getSnapshotCount());
+			bytesBefore.push_back(emulated->client->getBytesReceived());
+			for (int direction = 0; direction < 2; direction++) {
+				auto stats = emulated->emulator->getStats(static_cast<NetworkEmulator::Direction>(direction));
+				statsBefore[direction].dropped += stats.dropped;
+				statsBefore[direction].reordered += stats.reordered;
+				statsBefore[direction].delivered += stats.delivered;
+			}
+		}
+
+		// Every client sends a fixed input pattern, one input every 12 frames
+		auto start = std::chrono::steady_clock::now();
+		auto nextFrame = start;
+		for (int frameIndex = 0; std::chrono::steady_clock::now() < start + std::chrono::seconds(phase.seconds); frameIndex++) {
+			for (auto& emulated : clients) {
+				Client& client = *emulated->client;
+				uint64_t received;
+				do {
+					uint64_t snapshots = client.getSnapshotCount();
+					received = client.getBytesReceived();
+					client.receiveEntityUpdatesFromServer(&emulated->eventManager);
+					if (client.getSnapshotCount() != snapshots && client.getSnapshotLatencyUs() >= 0) {
+						emulated->latenciesUs.push_back(client.getSnapshotLatencyUs());
+					}
+				} while (client.getBytesReceived() != received);
+
+				client.receiveMessagesFromServer();
+				emulated->eventManager.process();
+				if (frameIndex % 12 == 0) client.sendInputToServer(inputs[(frameIndex / 12) % 4]);
+				client.sendHeartbeatToServer();
+			}
+
+			nextFrame += frame;
+			std::this_thread::sleep_until(nextFrame);
+		}
+		double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::vector<int64_t> latencies;
+		uint64_t snapshots = 0, bytes = 0;
+		uint64_t dropped = 0, reordered = 0, delivered = 0;
+		for (size_t i = 0; i < clients.size(); i++) {
+			EmulatedClient& emulated = *clients[i];
+			latencies.insert(latencies.end(), emulated.latenciesUs.begin(), emulated.latenciesUs.end());
+			snapshots += emulated.client->getSnapshotCount() - snapshotsBefore[i];
+			bytes += emulated.client->getBytesReceived() - bytesBefore[i];
+			for (int direction = 0; direction < 2; direction++) {
+				auto stats = emulated.emulator->getStats(static_cast<NetworkEmulator::Direction>(direction));
+				dropped += stats.dropped;
+				reordered += stats.reordered;
+				delivered += stats.delivered;
+			}
+		}
+		dropped -= statsBefore[0].dropped + statsBefore[1].dropped;
+		reordered -= statsBefore[0].reordered + statsBefore[1].reordered;
+		delivered -= statsBefore[0].delivered + statsBefore[1].delivered;
+
+		printf("%-10s %12.1f %9.1f ms %9.1f ms %10.1f %10llu %10llu %10llu\n", phase.name.c_str(),
+			snapshots / elapsed / clients.size(), percentile(latencies, 0.5) / 1000.0, percentile(latencies, 0.99) / 1000.0,
+			bytes / elapsed / clients.size() / 1024, static_cast<unsigned long long>(dropped),
+			static_cast<unsigned long long>(reordered), static_cast<unsigned long long>(delivered));
+		printf("           up: %s\n           down: %s\n", phase.upstream.toString().c_str(), phase.downstream.toString().c_str());
+	}
+
+	// The server cannot be stopped, so the process ends without tearing it down
+	fflush(stdout);
+	std::quick_exit(0);
+}
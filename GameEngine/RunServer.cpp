@@ -1,6 +1,8 @@
 #include "GameEngine.h"
 #include "Entity.h"
 #include "Server.h"
+#include "Profiler.h"
+#include <cstdlib>
 
 // Use this file to experiment with the Engine
 int main(int argc, char** argv) {
@@ -53,8 +55,15 @@ int main(int argc, char** argv) {
 	// Creating the server with the world entities and player entities.
 	Server server(entities);
 
-	server.setRefreshRate(RefreshRate::TWO_FORTY_FPS);
+	server.setRefreshRate(RefreshRate::SIXTY_FPS);                  // Fast entities are swept, so a low tick rate does not let them tunnel
 	server.setSimulationSpeed(1);
+
+	// Optional: number of threads simulating the world
+	if (argc > 1) server.getGameEngine()->setSimulationThreads(std::atoi(argv[1]));
+
+	// Optional: snapshots per second sent to each client, and each client's bandwidth budget in bytes per second
+	if (argc > 3) server.setSnapshotRate(std::atoi(argv[3]));
+	if (argc > 4) server.setClientBandwidth(std::atoll(argv[4]));
 	
 	// Applying physics
 	server.getGameEngine()->getPhysicsSystem()->applyPhysics(obstacle, 0);
@@ -62,6 +71,10 @@ int main(int argc, char** argv) {
 
 	// Initializing the server and simulating the game world in the server
 	server.initialize();
+
+	// Optional: port for live metrics (see MetricsMonitor)
+	if (argc > 2) server.enableMetrics(std::atoi(argv[2]));
+	PROFILE_CONSOLE();                                                      // "stats" / "trace [file]" on stdin in profiling builds
 	server.run();
 
 	return 0;
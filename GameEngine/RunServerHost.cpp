@@ -0,0 +1,47 @@
+#include "GameEngine.h"
+#include "Entity.h"
+#include "ServerHost.h"
+#include "Profiler.h"
+#include <cstdlib>
+
+// Builds the same world as RunServer for every room
+std::vector<Entity*> buildWorld(GameEngine& engine) {
+	// Player spawn point
+	Entity* spawnPoint = new Entity(Position(0, 100), Size(200, 200));
+	spawnPoint->setEntityType(EntityType::GHOST);
+	spawnPoint->setZoneType(ZoneType::SPAWN);
+
+	// Death zone
+	Entity* deathZone = new Entity(Position(500, 500), Size(100, 100));
+	deathZone->setEntityType(EntityType::GHOST);
+	deathZone->setZoneType(ZoneType::DEATH);
+
+	// Game world
+	Entity* platform = new Entity(Position(0, 600), Size(1920, 50));
+	Entity* obstacle = new Entity(Position(800, 100), Size(200, 200));
+	platform->setEntityType(EntityType::FIXED);
+
+	engine.getPhysicsSystem()->applyPhysics(*obstacle, 0);
+
+	return { spawnPoint, deathZone, platform, obstacle };
+}
+
+// Hosts several independent rooms in one process.
+// Usage: ServerHost [rooms] [simulation threads]
+int main(int argc, char** argv) {
+	int roomCount = argc > 1 ? std::atoi(argv[1]) : 8;
+	int threadCount = argc > 2 ? std::atoi(argv[2]) : 0;
+
+	ServerHost host(threadCount);
+	host.setRefreshRate(RefreshRate::ONE_TWENTY_FPS);
+
+	for (int roomId = 0; roomId < roomCount; roomId++) {
+		host.createRoom(roomId, buildWorld);
+	}
+
+	host.initialize();
+	PROFILE_CONSOLE();                                                      // "stats" / "trace [file]" on stdin in profiling builds
+	host.run();
+
+	return 0;
+}
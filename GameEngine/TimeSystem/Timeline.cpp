@@ -4,29 +4,15 @@
 int64_t Timeline::global_start_time = Timeline::now();
 
 Timeline::Timeline(Timeline* anchor, int64_t tic, TimelineType type) {
-    this->anchor = anchor;
-    this->tic = tic;
     this->type = type;
     this->start_time = (type == TimelineType::Global) ? global_start_time : now();
-    this->elapsed_pause_time = 0;
-    this->last_paused_time = 0;
-    this->paused = false;
-    this->speed = 1.0;
-    this->last_time = 0;
-    this->last_real_time = start_time;
+    publish(0, baseRealTime(anchor), tic, 1.0, false, anchor);
 }
 
 Timeline::Timeline() {
-    this->anchor = nullptr;
-    this->tic = 1;
     this->type = TimelineType::Global;
     this->start_time = now();
-    this->elapsed_pause_time = 0;
-    this->last_paused_time = 0;
-    this->paused = false;
-    this->speed = 1.0;
-    this->last_time = 0;
-    this->last_real_time = start_time;
+    publish(0, start_time, 1, 1.0, false, nullptr);
 }
 
 // Initialize the timeline, create a global timeline if the type is global else create a local timeline too
@@ -48,72 +34,114 @@ Timeline::~Timeline() {
 	delete currentLocalTimeline;
 }
 
+// Monotonic, so readers never see time going backwards
 int64_t Timeline::now() {
     return std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::high_resolution_clock::now().time_since_epoch()
+        std::chrono::steady_clock::now().time_since_epoch()
     ).count();
 }
 
-int64_t Timeline::getTime() {
-    std::lock_guard<std::mutex> lock(m);
-    return getTimeUnlocked();
+int64_t Timeline::sourceTime(Timeline* source) {
+    return (source != nullptr) ? source->getTime() : now();
 }
 
+// Anchored timelines count from the anchor's current time, unanchored ones from their start time
+int64_t Timeline::baseRealTime(Timeline* source) const {
+    return (source != nullptr) ? source->getTime() : start_time;
+}
 
-int64_t Timeline::getTimeUnlocked() {    
-    int64_t current_real_time = (anchor != nullptr) ? anchor->getTime() : now();
+// Writers make the sequence odd, store the new values and make it even again
+void Timeline::publish(int64_t new_base_time, int64_t new_base_real_time, int64_t new_tic, double new_speed, bool new_paused, Timeline* new_anchor) {
+    uint64_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
 
-    if (paused) {
-        return last_time;
+    base_time.store(new_base_time, std::memory_order_relaxed);
+    base_real_time.store(new_base_real_time, std::memory_order_relaxed);
+    tic.store(new_tic, std::memory_order_relaxed);
+    speed.store(new_speed, std::memory_order_relaxed);
+    paused.store(new_paused, std::memory_order_relaxed);
+    anchor.store(new_anchor, std::memory_order_relaxed);
+
+    sequence.store(current + 2, std::memory_order_release);
+}
+
+// Reads a consistent copy of the base values, retrying only if a writer published in between
+int64_t Timeline::getTime() {
+    int64_t snapshot_base_time, snapshot_base_real_time, snapshot_tic;
+    double snapshot_speed;
+    bool snapshot_paused;
+    Timeline* snapshot_anchor;
+
+    while (true) {
+        uint64_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+
+        snapshot_base_time = base_time.load(std::memory_order_relaxed);
+        snapshot_base_real_time = base_real_time.load(std::memory_order_relaxed);
+        snapshot_tic = tic.load(std::memory_order_relaxed);
+        snapshot_speed = speed.load(std::memory_order_relaxed);
+        snapshot_paused = paused.load(std::memory_order_relaxed);
+        snapshot_anchor = anchor.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) break;
     }
 
-    int64_t real_elapsed = (current_real_time - last_real_time) / tic;
-    int64_t scaled_elapsed = static_cast<int64_t>(real_elapsed * speed);
-    last_time += scaled_elapsed;
-    last_real_time = current_real_time;
+    if (snapshot_paused) {
+        return snapshot_base_time;
+    }
+
+    return project(snapshot_base_time, snapshot_base_real_time, snapshot_tic, snapshot_speed, sourceTime(snapshot_anchor));
+}
+
+int64_t Timeline::project(int64_t from_time, int64_t from_real_time, int64_t time_tic, double time_speed, int64_t real_time) {
+    int64_t real_elapsed = (real_time - from_real_time) / time_tic;
+    if (real_elapsed < 0) real_elapsed = 0;
+    return from_time + static_cast<int64_t>(real_elapsed * time_speed);
+}
 
-    return last_time;
+// Time at the given anchor time according to the current base values. Writers only.
+int64_t Timeline::timeAt(int64_t real_time) const {
+    return paused ? base_time.load() : project(base_time, base_real_time, tic, speed, real_time);
 }
 
+int64_t Timeline::getTimeUnlocked() {
+    return getTime();
+}
 
 void Timeline::pause() {
     std::lock_guard<std::mutex> lock(m);
     if (!paused) {
-        getTimeUnlocked(); // Update last_time before pausing
-        last_paused_time = (anchor != nullptr) ? anchor->getTime() : now();
-        paused = true;
+        Timeline* current_anchor = anchor.load();
+        int64_t real_time = sourceTime(current_anchor);
+        publish(timeAt(real_time), real_time, tic, speed, true, current_anchor);
     }
 }
 
-
+// Time spent paused is skipped: counting restarts from the anchor's current time
 void Timeline::resume() {
     std::lock_guard<std::mutex> lock(m);
     if (paused) {
-        int64_t current_time = (anchor != nullptr) ? anchor->getTime() : now();
-        elapsed_pause_time += current_time - last_paused_time;
-        last_real_time = current_time;
-        paused = false;
+        Timeline* current_anchor = anchor.load();
+        publish(base_time, sourceTime(current_anchor), tic, speed, false, current_anchor);
     }
 }
 
 void Timeline::reset() {
     std::lock_guard<std::mutex> lock(m);
-    start_time = (type == TimelineType::Global) ? global_start_time :
-        ((anchor != nullptr) ? anchor->getTime() : now());
-    elapsed_pause_time = 0;
-    last_paused_time = 0;
-    last_time = 0;
-    last_real_time = start_time;
-    paused = false;
+    Timeline* current_anchor = anchor.load();
+    start_time = (type == TimelineType::Global) ? global_start_time : sourceTime(current_anchor);
+    publish(0, baseRealTime(current_anchor), tic, speed, false, current_anchor);
 }
 
+// Keeps the current time and continues counting from the new anchor
 void Timeline::setAnchor(Timeline* new_anchor) {
     std::lock_guard<std::mutex> lock(m);
     if (anchor != new_anchor) {
-        int64_t current_time = getTime();
-        anchor = new_anchor;
-        reset();
-        last_time = current_time;
+        int64_t current_time = timeAt(sourceTime(anchor));
+        start_time = (type == TimelineType::Global) ? global_start_time : sourceTime(new_anchor);
+        publish(current_time, baseRealTime(new_anchor), tic, speed, false, new_anchor);
     }
 }
 
@@ -121,8 +149,9 @@ void Timeline::setAnchor(Timeline* new_anchor) {
 void Timeline::changeTic(int64_t new_tic) {
     std::lock_guard<std::mutex> lock(m);
     if (tic != new_tic) {
-        getTime(); // Update last_time before changing tic
-        tic = new_tic;
+        Timeline* current_anchor = anchor.load();
+        int64_t real_time = sourceTime(current_anchor);
+        publish(timeAt(real_time), real_time, new_tic, speed, paused, current_anchor);
     }
 }
 
@@ -137,13 +166,13 @@ bool Timeline::isPaused() const {
 void Timeline::setSpeed(double new_speed) {
     std::lock_guard<std::mutex> lock(m);
     if (speed != new_speed) {
-        getTimeUnlocked(); // Update last_time before changing speed
-        speed = new_speed;
+        Timeline* current_anchor = anchor.load();
+        int64_t real_time = sourceTime(current_anchor);
+        publish(timeAt(real_time), real_time, tic, new_speed, paused, current_anchor);
     }
 }
 
 double Timeline::getSpeed() {
-    std::lock_guard<std::mutex> lock(m);
     return speed;
 }
 
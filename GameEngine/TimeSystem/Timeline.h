@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <mutex>
 #include <chrono>
 
@@ -7,25 +8,37 @@ enum class TimelineType {
     Global
 };
 
+// The time of a timeline is a linear function of its anchor's time (or the clock):
+//   time = base_time + (anchor_time - base_real_time) / tic * speed
+// Writers (pause, resume, setSpeed, ...) are serialized by a mutex and republish the base values
+// under a sequence counter. getTime never locks; it reads a consistent copy of the base values and
+// computes the time from the clock, so any number of threads can read concurrently.
 class Timeline {
 private:
-    std::mutex m;                   // for thread safety
-    int64_t elapsed_pause_time;      
-    int64_t last_paused_time; 
+    std::mutex m;                              // Serializes writers only
+    std::atomic<uint64_t> sequence{ 0 };      // Odd while a writer is publishing
+    std::atomic<int64_t> base_time{ 0 };      // Time of the timeline at base_real_time
+    std::atomic<int64_t> base_real_time{ 0 }; // Anchor (or clock) time the base was taken at
+    std::atomic<int64_t> tic{ 1 };             // Time units relative to anchor
+    std::atomic<double> speed{ 1.0 };          // for time manipulation
+    std::atomic<bool> paused{ false };
+    std::atomic<Timeline*> anchor{ nullptr };
+
 	int64_t start_time;              // Start time of the timeline
-    int64_t tic;                     // Time units relative to anchor
-    bool paused;                     
-    Timeline* anchor;                
     TimelineType type;               // Type of timeline (Local or Global)
     static int64_t now();            // gets current time
 	static int64_t global_start_time; //start time of the global timeline
-	double speed;                    // for time manipulation
-    int64_t last_time;               // lst calculated logical time
-    int64_t last_real_time;          // al time used for calculation
 
-    Timeline* globalTimeline;
-    Timeline* currentLocalTimeline;
+    Timeline* globalTimeline = nullptr;
+    Timeline* currentLocalTimeline = nullptr;
 
+    // Time of the anchor, or of the clock for unanchored timelines
+    static int64_t sourceTime(Timeline* source);
+    int64_t baseRealTime(Timeline* source) const;
+    static int64_t project(int64_t from_time, int64_t from_real_time, int64_t time_tic, double time_speed, int64_t real_time);
+    int64_t timeAt(int64_t real_time) const;
+    // Publishes new base values. Must be called with the writer lock held.
+    void publish(int64_t new_base_time, int64_t new_base_real_time, int64_t new_tic, double new_speed, bool new_paused, Timeline* new_anchor);
 
 public:
     // Constructor for client timelines with anchor
@@ -38,8 +51,9 @@ public:
 
     ~Timeline();
 
-    // Get elapsed time in ns
+    // Get elapsed time in ns. Lock-free.
     int64_t getTime();
+    // Same as getTime, which no longer takes a lock
     int64_t getTimeUnlocked();
 
     void pause();
@@ -66,4 +80,4 @@ public:
     double getSpeed();
 
     void createNewLocalTimeline();
-};
\ No newline at end of file
+};
@@ -0,0 +1,81 @@
+#include "TestHarness.h"
+#include "CollisionSystem.h"
+#include <cmath>
+
+static bool overlap(const Entity& a, const Entity& b) {
+	bool result = CollisionSystem::overlaps(CollisionSystem::shapeOf(a), CollisionSystem::shapeOf(b));
+	// The test is symmetric
+	if (result != CollisionSystem::overlaps(CollisionSystem::shapeOf(b), CollisionSystem::shapeOf(a))) {
+		TestHarness::fail(__FILE__, __LINE__, "overlaps(a, b) == overlaps(b, a)");
+	}
+	return result;
+}
+
+// Rectangles are placed by their top left corner, circles by their center and triangles by the left end of
+// their base; triangles point up.
+void registerCollisionTests(TestHarness& harness) {
+	harness.add("CollisionSystem rectangles", [] {
+		Entity a(Position(0, 0), Size(20, 20));
+		CHECK(overlap(a, Entity(Position(10, 10), Size(20, 20))));
+		CHECK(overlap(a, Entity(Position(5, 5), Size(2, 2))));
+		CHECK(!overlap(a, Entity(Position(20, 0), Size(20, 20))));           // Touching
+		CHECK(!overlap(a, Entity(Position(0, 30), Size(20, 20))));
+		CHECK(!overlap(a, Entity(Position(5, 5), Size(0, 0))));              // Empty shapes never collide
+	});
+
+	harness.add("CollisionSystem circles", [] {
+		Entity a(Position(0, 0), 10.0f);
+		CHECK(overlap(a, Entity(Position(12, 0), 10.0f)));
+		CHECK(!overlap(a, Entity(Position(15, 15), 10.0f)));                 // Bounds overlap, circles do not
+		CHECK(!overlap(a, Entity(Position(20, 0), 10.0f)));                  // Touching
+	});
+
+	harness.add("CollisionSystem circle against rectangle", [] {
+		Entity circle(Position(0, 0), 10.0f);
+		CHECK(overlap(circle, Entity(Position(5, 5), Size(10, 10))));
+		CHECK(!overlap(circle, Entity(Position(8, 8), Size(10, 10))));       // Near the corner, outside the circle
+		CHECK(overlap(circle, Entity(Position(-5, 8), Size(10, 10))));       // Along an edge
+		CHECK(overlap(circle, Entity(Position(-50, -50), Size(100, 100))));  // Inside the rectangle
+	});
+
+	harness.add("CollisionSystem triangle against rectangle and circle", [] {
+		Entity triangle(Position(0, 100), 100.0f, 100.0f);                    // Apex at (50, 0)
+		CHECK(overlap(triangle, Entity(Position(45, 45), Size(10, 10))));
+		CHECK(!overlap(triangle, Entity(Position(0, 0), Size(20, 20))));     // Beside the slope
+		CHECK(overlap(triangle, Entity(Position(-10, 90), Size(20, 20))));   // Across the base corner
+
+		CHECK(overlap(triangle, Entity(Position(50, 60), 5.0f)));
+		CHECK(!overlap(triangle, Entity(Position(10, 10), 10.0f)));          // Beside the slope
+		CHECK(overlap(triangle, Entity(Position(50, 105), 10.0f)));          // Below the base, reaching into it
+	});
+
+	harness.add("CollisionSystem triangles", [] {
+		Entity triangle(Position(0, 100), 100.0f, 100.0f);
+		CHECK(overlap(triangle, Entity(Position(30, 100), 100.0f, 100.0f)));
+		CHECK(!overlap(triangle, Entity(Position(70, 20), 100.0f, 100.0f))); // Bounds overlap, triangles do not
+		CHECK(!overlap(triangle, Entity(Position(200, 100), 100.0f, 100.0f)));
+	});
+
+	harness.add("CollisionSystem sweep finds the first contact", [] {
+		Entity mover(Position(0, 0), Size(10, 10));
+		Entity right(Position(50, 0), Size(10, 10));
+		Entity below(Position(0, 50), Size(10, 10));
+
+		CollisionSystem::Impact impact = CollisionSystem::sweep(mover, 100, 0, right);
+		CHECK(std::abs(impact.time - 0.4f) < 1e-5f);
+		CHECK(impact.xAxis);
+
+		impact = CollisionSystem::sweep(mover, 0, 100, below);
+		CHECK(std::abs(impact.time - 0.4f) < 1e-5f);
+		CHECK(!impact.xAxis);
+
+		CHECK(CollisionSystem::sweep(mover, -100, 0, right).time > 1.0f);    // Moving away
+		CHECK(CollisionSystem::sweep(mover, 30, 0, right).time > 1.0f);      // Stops short
+		CHECK(CollisionSystem::sweep(mover, 100, 0, Entity(Position(5, 5), Size(10, 10))).time > 1.0f);  // Already overlapping
+
+		// Swept shapes use their bounds, so a fast circle is stopped by what its box reaches first
+		Entity circle(Position(5, 5), 5.0f);
+		impact = CollisionSystem::sweep(circle, 100, 0, right);
+		CHECK(std::abs(impact.time - 0.4f) < 1e-5f);
+	});
+}
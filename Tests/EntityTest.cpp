@@ -0,0 +1,73 @@
+#include "TestHarness.h"
+#include "Entity.h"
+#include "EntityRegistry.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+void registerEntityTests(TestHarness& harness) {
+	harness.add("EntityRegistry resolves live handles", [] {
+		Entity entity(Position(0, 0), Size(10, 10));
+		EntityHandle handle = entity.getHandle();
+
+		CHECK(!handle.isNull());
+		CHECK(EntityRegistry::getInstance().get(handle) == &entity);
+		CHECK(EntityRegistry::getInstance().get(EntityHandle()) == nullptr);
+	});
+
+	harness.add("EntityRegistry stale handles resolve to nullptr", [] {
+		Entity* first = new Entity(Position(0, 0), Size(10, 10));
+		EntityHandle stale = first->getHandle();
+		size_t liveBefore = EntityRegistry::getInstance().size();
+		delete first;
+
+		CHECK(EntityRegistry::getInstance().get(stale) == nullptr);
+		CHECK(EntityRegistry::getInstance().size() == liveBefore - 1);
+
+		// The freed slot is reused with the next generation, so the old handle stays stale
+		Entity second(Position(0, 0), Size(10, 10));
+		EntityHandle current = second.getHandle();
+		CHECK(current.index == stale.index);
+		CHECK(current.generation != stale.generation);
+		CHECK(current != stale);
+		CHECK(EntityRegistry::getInstance().get(stale) == nullptr);
+		CHECK(EntityRegistry::getInstance().get(current) == &second);
+
+		// Removing a stale handle leaves the slot's new entity alone
+		EntityRegistry::getInstance().remove(stale);
+		CHECK(EntityRegistry::getInstance().get(current) == &second);
+	});
+
+	harness.add("EntityRegistry lookups during concurrent churn", [] {
+		Entity stable(Position(0, 0), Size(10, 10));
+		EntityHandle handle = stable.getHandle();
+		std::atomic<bool> running{ true };
+		std::atomic<int> wrong{ 0 };
+
+		std::thread reader([&] {
+			while (running) {
+				if (EntityRegistry::getInstance().get(handle) != &stable) wrong++;
+			}
+		});
+
+		std::vector<EntityHandle> stale;
+		for (int round = 0; round < 200; round++) {
+			std::vector<Entity*> entities;
+			for (int i = 0; i < 50; i++) entities.push_back(new Entity(Position(0, 0), Size(1, 1)));
+			for (Entity* entity : entities) {
+				stale.push_back(entity->getHandle());
+				delete entity;
+			}
+		}
+		running = false;
+		reader.join();
+
+		CHECK(wrong == 0);
+		for (const EntityHandle& old : stale) {
+			if (EntityRegistry::getInstance().get(old) != nullptr) {
+				CHECK(EntityRegistry::getInstance().get(old) == nullptr);
+				break;
+			}
+		}
+	});
+}
@@ -0,0 +1,82 @@
+#include "TestHarness.h"
+#include "FrameArena.h"
+#include "MemoryPool.h"
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <vector>
+
+void registerMemoryTests(TestHarness& harness) {
+	harness.add("MemoryPool reuses freed blocks", [] {
+		MemoryPool pool(48, 8);
+		CHECK(pool.getBlockSize() >= 48);
+
+		std::vector<void*> blocks;
+		for (int i = 0; i < 20; i++) {
+			void* block = pool.allocate();
+			CHECK(reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t) == 0);
+			memset(block, i, 48);
+			blocks.push_back(block);
+		}
+		CHECK(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+		CHECK(pool.getUsedCount() == 20);
+		size_t capacity = pool.getCapacity();
+		CHECK(capacity >= 20);
+
+		std::set<void*> freed(blocks.begin(), blocks.end());
+		for (void* block : blocks) pool.deallocate(block);
+		CHECK(pool.getUsedCount() == 0);
+
+		// Once grown to the peak, the pool hands out the same blocks again without growing
+		for (int round = 0; round < 3; round++) {
+			blocks.clear();
+			for (int i = 0; i < 20; i++) blocks.push_back(pool.allocate());
+			for (void* block : blocks) CHECK(freed.count(block) == 1);
+			for (void* block : blocks) pool.deallocate(block);
+		}
+		CHECK(pool.getCapacity() == capacity);
+	});
+
+	harness.add("FrameArena reuses its buffer after reset", [] {
+		FrameArena arena(1024);
+		void* first = arena.allocate(100);
+		CHECK(arena.getUsed() >= 100);
+
+		void* aligned = arena.allocate(8, 64);
+		CHECK(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+
+		arena.reset();
+		CHECK(arena.getUsed() == 0);
+		CHECK(arena.allocate(100) == first);
+	});
+
+	harness.add("FrameArena grows to cover a step that overflowed", [] {
+		FrameArena arena(256);
+		for (int i = 0; i < 10; i++) memset(arena.allocate(100), i, 100);
+		CHECK(arena.getUsed() >= 1000);
+
+		arena.reset();
+		CHECK(arena.getCapacity() >= 1000);
+
+		// A step of the same size now fits in the arena
+		size_t capacity = arena.getCapacity();
+		for (int round = 0; round < 3; round++) {
+			for (int i = 0; i < 10; i++) arena.allocate(100);
+			arena.reset();
+		}
+		CHECK(arena.getCapacity() == capacity);
+	});
+
+	harness.add("FrameVector keeps its storage in the arena", [] {
+		FrameArena arena(4096);
+		{
+			FrameVector<int> values{ FrameArena::Allocator<int>(arena) };
+			values.reserve(100);
+			for (int i = 0; i < 100; i++) values.push_back(i);
+			CHECK(values[99] == 99);
+			CHECK(arena.getUsed() >= 100 * sizeof(int));
+		}
+		arena.reset();
+		CHECK(arena.getUsed() == 0);
+	});
+}
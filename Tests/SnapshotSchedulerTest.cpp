@@ -0,0 +1,104 @@
+#include "TestHarness.h"
+#include "SnapshotScheduler.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+using Clock = SnapshotScheduler::Clock;
+
+static std::vector<std::unique_ptr<Entity>> makeRow(int count, float spacing) {
+	std::vector<std::unique_ptr<Entity>> row;
+	for (int i = 0; i < count; i++) {
+		row.emplace_back(new Entity(Position(i * spacing, 0), Size(10, 10)));
+	}
+	return row;
+}
+
+static std::vector<Entity*> view(const std::vector<std::unique_ptr<Entity>>& row) {
+	std::vector<Entity*> entities;
+	for (const auto& entity : row) entities.push_back(entity.get());
+	return entities;
+}
+
+void registerSnapshotSchedulerTests(TestHarness& harness) {
+	harness.add("SnapshotScheduler unlimited clients get the whole world at the snapshot rate", [] {
+		auto row = makeRow(20, 100);
+		std::vector<Entity*> entities = view(row), selected;
+		SnapshotScheduler scheduler;
+		scheduler.setSnapshotRate(20);
+		scheduler.addClient(1);
+
+		Clock::time_point now = Clock::now();
+		CHECK(scheduler.schedule(1, entities[0], entities, now, selected));
+		CHECK(selected.size() == entities.size());
+
+		// Nothing is due until the next interval
+		CHECK(!scheduler.schedule(1, entities[0], entities, now + std::chrono::milliseconds(10), selected));
+		CHECK(selected.empty());
+		CHECK(scheduler.schedule(1, entities[0], entities, now + std::chrono::milliseconds(50), selected));
+
+		CHECK(!scheduler.schedule(2, nullptr, entities, now, selected));
+		scheduler.removeClient(1);
+		CHECK(!scheduler.schedule(1, entities[0], entities, now + std::chrono::seconds(1), selected));
+	});
+
+	harness.add("SnapshotScheduler budget picks the player first and rotates the rest", [] {
+		auto row = makeRow(20, 300);
+		std::vector<Entity*> entities = view(row), selected;
+		SnapshotScheduler scheduler;
+		scheduler.setSnapshotRate(60);
+		scheduler.setMinSnapshotRate(10);
+		scheduler.addClient(1, 6000);
+
+		Entity* player = entities[0];
+		std::map<Entity*, int> sent;
+		int snapshots = 0;
+		size_t largest = 0;
+		Clock::time_point now = Clock::now();
+
+		for (int i = 0; i < 2000; i++) {
+			now += std::chrono::milliseconds(5);
+			if (!scheduler.schedule(1, player, entities, now, selected)) continue;
+
+			snapshots++;
+			CHECK(!selected.empty() && selected.front() == player);
+			largest = std::max(largest, selected.size());
+			for (Entity* entity : selected) sent[entity]++;
+			scheduler.recordSent(1, 80 + 250 * selected.size(), selected.size());
+		}
+
+		// 10 s at 6000 B/s is far less than 60 full worlds per second
+		CHECK(snapshots > 0);
+		CHECK(largest < entities.size());
+		CHECK(sent[player] == snapshots);
+		CHECK(scheduler.getClientRate(1) < 60);
+
+		// Far away entities still go out, just less often than near ones
+		for (Entity* entity : entities) CHECK(sent[entity] > 0);
+		CHECK(sent[entities[1]] > sent[entities[19]]);
+	});
+
+	harness.add("SnapshotScheduler skips snapshots the budget cannot pay for", [] {
+		auto row = makeRow(10, 100);
+		std::vector<Entity*> entities = view(row), selected;
+		SnapshotScheduler scheduler;
+		scheduler.setSnapshotRate(60);
+		scheduler.addClient(1, 1000);
+
+		Clock::time_point now = Clock::now();
+		int sentBytes = 0;
+		for (int i = 0; i < 600; i++) {
+			now += std::chrono::milliseconds(16);
+			if (!scheduler.schedule(1, entities[0], entities, now, selected)) continue;
+			size_t bytes = 80 + 250 * selected.size();
+			sentBytes += static_cast<int>(bytes);
+			scheduler.recordSent(1, bytes, selected.size());
+		}
+
+		// A budget below one snapshot at the minimum rate still gets snapshots with the player, within about
+		// 9.6 s of budget plus the credit an idle client may save up
+		CHECK(sentBytes > 0);
+		CHECK(sentBytes <= 1000 * 10 + 330);
+	});
+}
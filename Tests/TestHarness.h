@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Runs registered test cases and reports the ones whose checks failed. A failed CHECK is reported and the
+// case keeps running, so one run shows every broken expectation of a case.
+// Options: --filter=<substring>
+class TestHarness {
+public:
+	using Case = std::function<void()>;
+
+	TestHarness(int argc, char** argv) {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg.rfind("--filter=", 0) == 0) _filter = arg.substr(arg.find('=') + 1);
+			else {
+				fprintf(stderr, "Unknown option: %s\n", arg.c_str());
+				fprintf(stderr, "Options: --filter=<substring>\n");
+				std::exit(1);
+			}
+		}
+	}
+
+	void add(const std::string& name, const Case& test) { _cases.push_back({ name, test }); }
+
+	// Runs all cases that match the filter. Returns the process exit code.
+	int run() {
+		int run = 0, failed = 0;
+		for (const Registered& registered : _cases) {
+			if (!_filter.empty() && registered.name.find(_filter) == std::string::npos) continue;
+
+			int failuresBefore = failures();
+			registered.test();
+			run++;
+
+			bool passed = failures() == failuresBefore;
+			if (!passed) failed++;
+			fprintf(stderr, "%-60s %s\n", registered.name.c_str(), passed ? "ok" : "FAILED");
+		}
+
+		fprintf(stderr, "\n%d of %d cases passed\n", run - failed, run);
+		return failed == 0 && run > 0 ? 0 : 1;
+	}
+
+	static void fail(const char* file, int line, const char* expression) {
+		fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+		failures()++;
+	}
+
+private:
+	struct Registered {
+		std::string name;
+		Case test;
+	};
+
+	static int& failures() {
+		static int count = 0;
+		return count;
+	}
+
+	std::vector<Registered> _cases;
+	std::string _filter;
+};
+
+#define CHECK(condition) do { if (!(condition)) TestHarness::fail(__FILE__, __LINE__, #condition); } while (false)
+
+// Registration functions of the test files, called by TestMain.cpp
+void registerEntityTests(TestHarness& harness);
+void registerWorldBlobTests(TestHarness& harness);
+void registerMemoryTests(TestHarness& harness);
+void registerSnapshotSchedulerTests(TestHarness& harness);
+void registerCollisionTests(TestHarness& harness);
+void registerTimelineTests(TestHarness& harness);
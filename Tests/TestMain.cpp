@@ -0,0 +1,16 @@
+#include "TestHarness.h"
+
+// Assertion-based tests of the engine's subsystems. Exits with 1 if any case failed.
+// Usage: EngineTests [--filter=<substring>]
+int main(int argc, char** argv) {
+	TestHarness harness(argc, argv);
+
+	registerEntityTests(harness);
+	registerWorldBlobTests(harness);
+	registerMemoryTests(harness);
+	registerSnapshotSchedulerTests(harness);
+	registerCollisionTests(harness);
+	registerTimelineTests(harness);
+
+	return harness.run();
+}
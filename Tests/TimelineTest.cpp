@@ -0,0 +1,75 @@
+#include "TestHarness.h"
+#include "Timeline.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static int64_t steadyNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void registerTimelineTests(TestHarness& harness) {
+	harness.add("Timeline pause holds the time", [] {
+		Timeline timeline;
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		timeline.pause();
+		CHECK(timeline.isPaused());
+
+		int64_t paused = timeline.getTime();
+		CHECK(paused > 0);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		CHECK(timeline.getTime() == paused);
+
+		// Time spent paused is skipped
+		timeline.resume();
+		CHECK(!timeline.isPaused());
+		CHECK(timeline.getTime() >= paused);
+		CHECK(timeline.getTime() < paused + std::chrono::nanoseconds(std::chrono::milliseconds(20)).count());
+	});
+
+	harness.add("Timeline anchored tic", [] {
+		Timeline anchor;
+		Timeline scaled(&anchor, 2);
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		anchor.pause();
+		scaled.pause();
+
+		// The anchored timeline counts one unit per two units of its anchor
+		CHECK(scaled.getTime() <= anchor.getTime() / 2 + 1);
+		CHECK(scaled.getTime() > 0);
+	});
+
+	harness.add("Timeline seqlock readers never see a torn base", [] {
+		// With speeds up to 1 and pauses, the time never runs ahead of the clock. A reader that combined the
+		// base time of one publish with the base clock time of an earlier one would see it run ahead.
+		int64_t start = steadyNs();
+		Timeline timeline;
+		std::atomic<bool> running{ true };
+		std::atomic<int> torn{ 0 };
+		std::atomic<uint64_t> reads{ 0 };
+
+		std::vector<std::thread> readers;
+		for (int i = 0; i < 3; i++) {
+			readers.emplace_back([&] {
+				while (running) {
+					int64_t time = timeline.getTime();
+					if (time < 0 || time > steadyNs() - start) torn++;
+					reads++;
+				}
+			});
+		}
+
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+		for (int i = 0; std::chrono::steady_clock::now() < deadline; i++) {
+			timeline.setSpeed(i % 2 == 0 ? 0.5 : 1.0);
+			timeline.pause();
+			timeline.resume();
+		}
+		running = false;
+		for (std::thread& reader : readers) reader.join();
+
+		CHECK(reads > 0);
+		CHECK(torn == 0);
+	});
+}
@@ -0,0 +1,129 @@
+#include "TestHarness.h"
+#include "WorldBlob.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+static std::vector<std::unique_ptr<Entity>> makeWorld() {
+	std::vector<std::unique_ptr<Entity>> world;
+	for (int i = 0; i < 5; i++) {
+		std::unique_ptr<Entity> entity(new Entity(Position(10.5f * i, -3.25f * i), Size(20.0f + i, 30.0f), SDL_Color{ 10, 20, 30, 40 }));
+		entity->setEntityType(i % 2 == 0 ? EntityType::FIXED : EntityType::DEFAULT);
+		entity->setZoneType(i == 4 ? ZoneType::SPAWN : ZoneType::NONE);
+		entity->setVelocityX(1.5f * i);
+		entity->setVelocityY(-2.0f);
+		entity->setAccelerationY(9.8f);
+		entity->setRotationAngle(45.0f);
+		entity->setTexturePath(i == 2 ? "Textures/brick.png" : "");
+		world.push_back(std::move(entity));
+	}
+	return world;
+}
+
+static std::vector<const Entity*> view(const std::vector<std::unique_ptr<Entity>>& world) {
+	std::vector<const Entity*> entities;
+	for (const auto& entity : world) entities.push_back(entity.get());
+	return entities;
+}
+
+static bool sameEntity(const Entity& a, const Entity& b) {
+	SDL_Color colorA = a.getColor(), colorB = b.getColor();
+	return a.getEntityID() == b.getEntityID()
+		&& a.getOriginalPosition().x == b.getOriginalPosition().x && a.getOriginalPosition().y == b.getOriginalPosition().y
+		&& a.getSize().width == b.getSize().width && a.getSize().height == b.getSize().height
+		&& a.getEntityType() == b.getEntityType() && a.getZoneType() == b.getZoneType()
+		&& a.getVelocityX() == b.getVelocityX() && a.getVelocityY() == b.getVelocityY()
+		&& a.getAccelerationX() == b.getAccelerationX() && a.getAccelerationY() == b.getAccelerationY()
+		&& a.getRotationAngle() == b.getRotationAngle() && a.getTexturePath() == b.getTexturePath()
+		&& colorA.r == colorB.r && colorA.g == colorB.g && colorA.b == colorB.b && colorA.a == colorB.a;
+}
+
+static void deleteAll(std::vector<Entity*>& entities) {
+	for (Entity* entity : entities) delete entity;
+	entities.clear();
+}
+
+void registerWorldBlobTests(TestHarness& harness) {
+	harness.add("WorldBlob encode/decode round trip", [] {
+		auto world = makeWorld();
+		std::string blob = WorldBlob::encode(view(world));
+
+		std::vector<Entity*> decoded;
+		CHECK(WorldBlob::decode(blob.data(), blob.size(), decoded));
+		CHECK(decoded.size() == world.size());
+		for (size_t i = 0; i < decoded.size() && i < world.size(); i++) {
+			CHECK(sameEntity(*decoded[i], *world[i]));
+		}
+		deleteAll(decoded);
+	});
+
+	harness.add("WorldBlob hash covers the records", [] {
+		auto world = makeWorld();
+		std::string blob = WorldBlob::encode(view(world));
+
+		CHECK(WorldBlob::verify(blob));
+		CHECK(WorldBlob::hashOf(blob) != 0);
+		CHECK(WorldBlob::hashOf(blob) == WorldBlob::hashOf(WorldBlob::encode(view(world))));
+		CHECK(WorldBlob::hashOf("not a blob") == 0);
+
+		world[3]->setVelocityX(100.0f);
+		CHECK(WorldBlob::hashOf(WorldBlob::encode(view(world))) != WorldBlob::hashOf(blob));
+	});
+
+	harness.add("WorldBlob rejects corrupt and truncated blobs", [] {
+		auto world = makeWorld();
+		std::string blob = WorldBlob::encode(view(world));
+		std::vector<Entity*> decoded;
+
+		std::string corrupt = blob;
+		corrupt[corrupt.size() - 10] ^= 0x5a;
+		CHECK(!WorldBlob::verify(corrupt));
+		CHECK(!WorldBlob::decode(corrupt.data(), corrupt.size(), decoded));
+		CHECK(decoded.empty());
+
+		CHECK(!WorldBlob::decode(blob.data(), blob.size() - 1, decoded));
+		CHECK(!WorldBlob::decode(blob.data(), 3, decoded));
+		CHECK(decoded.empty());
+	});
+
+	harness.add("WorldBlob handshake skips a cached static world", [] {
+		auto world = makeWorld();
+		std::vector<Entity*> entities, physicsEntities;
+		for (const auto& entity : world) entities.push_back(entity.get());
+		physicsEntities.push_back(world[1].get());
+		physicsEntities.push_back(world[3].get());
+
+		WorldBlob worldBlob;
+		std::string staticBlob, dynamicBlob;
+		uint64_t staticHash = 0;
+
+		std::string full = worldBlob.buildHandshake(entities, physicsEntities, 0);
+		CHECK(WorldBlob::parseHandshake(full.data(), full.size(), staticBlob, staticHash, dynamicBlob));
+		CHECK(WorldBlob::verify(staticBlob));
+		CHECK(WorldBlob::verify(dynamicBlob));
+
+		std::vector<Entity*> staticEntities, dynamicEntities;
+		CHECK(WorldBlob::decode(staticBlob.data(), staticBlob.size(), staticEntities));
+		CHECK(WorldBlob::decode(dynamicBlob.data(), dynamicBlob.size(), dynamicEntities));
+		CHECK(staticEntities.size() == 3);
+		CHECK(dynamicEntities.size() == 2);
+
+		uint64_t cachedHash = WorldBlob::hashOf(staticBlob);
+		std::string cached = worldBlob.buildHandshake(entities, physicsEntities, cachedHash);
+		CHECK(cached.size() < full.size());
+		CHECK(WorldBlob::parseHandshake(cached.data(), cached.size(), staticBlob, staticHash, dynamicBlob));
+		CHECK(staticBlob.empty());
+		CHECK(staticHash == cachedHash);
+
+		deleteAll(staticEntities);
+		deleteAll(dynamicEntities);
+	});
+
+	harness.add("WorldBlob connect request round trip", [] {
+		std::string request = WorldBlob::formatConnectRequest(2, 0x1234abcdULL, 6000);
+		CHECK(WorldBlob::parseCachedHash(request) == 0x1234abcdULL);
+		CHECK(WorldBlob::parseBandwidth(request) == 6000);
+		CHECK(WorldBlob::formatConnectRequest(-1, 0) == "CONNECT");
+		CHECK(WorldBlob::parseCachedHash("CONNECT") == 0);
+	});
+}